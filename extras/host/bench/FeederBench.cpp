@@ -0,0 +1,128 @@
+/*
+ * Host benchmark of the stream feeder, the decoder fed from the DREQ pin change
+ * interrupt (pcint, AudioStream filled by the main loop and refilled by the interrupt
+ * when it is late) or polled by a 1 kHz timer interrupt reading the card itself in
+ * chunks of 32 bytes (timer, as Adafruit_VS1053_FilePlayer::feedBuffer() before):
+ *   FeederBench <pcint|timer> <busy>   csv line for 10s of audio, the main loop
+ *                                      blocked for <busy> ms every 500 ms (not
+ *                                      accessing the card, e.g. I2C or Serial)
+ *   FeederBench                        the csv header
+ * The interrupt calls per second of audio (all and those sending no data), the
+ * lowest/highest FIFO fill after the start, the underruns and the blocks read from
+ * the card are reported. See 'make bench'.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <Arduino.h>
+#include <Adafruit_VS1053.h>
+#include "AudioStream.h"
+
+#define AUDIO_MS      10000
+#define WARMUP_MS       100    // FIFO filled after the start
+#define BUSY_PERIOD     500    // [ms]
+#define SLEEP_STEP       50    // [us] resolution of the simulated idle time
+
+Adafruit_VS1053 codec(-1, -1, -1, 9);
+AudioStream stream(codec);
+File track;
+bool timerFeeder;
+uint32_t timerCalls = 0;
+uint32_t emptyCalls = 0;
+
+
+/*
+ * Feed from an interrupt, counting the calls that sent nothing.
+ */
+void feed() {
+  uint32_t fed = codec.stats.bytesFed;
+  stream.feed();
+  if (codec.stats.bytesFed == fed) emptyCalls++;
+}
+
+ISR(PCINT0_vect) {
+  feed();
+}
+
+/*
+ * Timer interrupt at each millisecond, reads the card while the decoder requests data.
+ */
+void onClock() {
+  static unsigned long last = 0;
+  if (!timerFeeder || millis() == last) return;
+  last = millis();
+  timerCalls++;
+  uint32_t fed = codec.stats.bytesFed;
+  byte buffer[VS1053_DATABUFFERLEN];
+  while (codec.readyForData()) {
+    int length = track.read(buffer, sizeof(buffer));
+    if (length <= 0) break;
+    codec.playData(buffer, length);
+  }
+  if (codec.stats.bytesFed == fed) emptyCalls++;
+}
+
+/*
+ * Advance the clock in small steps (interrupt latency).
+ */
+void pass(unsigned long us) {
+  while (us > 0) {
+    unsigned long step = min(us, (unsigned long)SLEEP_STEP);
+    advanceMicros(step);
+    us -= step;
+  }
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    printf("feeder,busyMs,isrPerSecond,emptyPerSecond,minFill,maxFill,underruns,sdBlocks\n");
+    return 0;
+  }
+  timerFeeder = strcmp(argv[1], "timer") == 0;
+  unsigned long busy = atol(argv[2]);
+
+  SD.mount("sd/FeederBench");
+  File file = SD.open("TRACK.MP3", FILE_WRITE);
+  for (unsigned long i = 0; i < (AUDIO_MS + 1000UL) * VS1053_BYTES_PER_MS; i++) file.write((uint8_t)i);
+  file.close();
+
+  if (!timerFeeder) {
+    PCMSK0 |= bit(digitalPinToPCMSKbit(9));
+    PCICR |= bit(0);
+  }
+  codec.begin();
+  addClockListener(onClock);
+  track = SD.open("TRACK.MP3");
+  if (!timerFeeder) stream.start(track);
+
+  // main loop: fill the stream, sleep until the next millisecond (timer1 of the sketch)
+  unsigned long start = millis();
+  unsigned long nextBusy = start + BUSY_PERIOD;
+  bool measuring = false;
+  uint32_t interrupts = 0;
+  uint32_t empty = 0;
+  while ((long)(millis() - start) < AUDIO_MS) {
+    if (!measuring && (long)(millis() - start) >= WARMUP_MS) {
+      measuring = true;
+      memset(&codec.stats, 0, sizeof(codec.stats));
+      interrupts = codec.interrupts + timerCalls;
+      empty = emptyCalls;
+      SD.stats = SdStats();
+    }
+    if (!timerFeeder) stream.fill();
+    if (busy > 0 && (long)(millis() - nextBusy) >= 0) {
+      pass(busy * 1000);
+      nextBusy += BUSY_PERIOD;
+    }
+    pass(1000 - micros() % 1000);
+  }
+
+  uint32_t calls = codec.interrupts + timerCalls - interrupts;
+  printf("%s,%lu,%lu,%lu,%u,%u,%u,%u\n", timerFeeder ? "timer" : "pcint", busy,
+         (unsigned long)calls * 1000 / (AUDIO_MS - WARMUP_MS),
+         (unsigned long)(emptyCalls - empty) * 1000 / (AUDIO_MS - WARMUP_MS),
+         codec.stats.minFill, codec.stats.maxFill, codec.stats.underruns, SD.stats.blocks);
+  return 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * Host benchmark of the latency from a user action to the first audio data sent
+ * to the decoder, for a given number of nfc.cfg entries and tracks of the album:
+ *   LatencyBench <entries> <tracks>   one csv line per path (boot, key, next, nfc)
+ *   LatencyBench                      the csv header
+ * The time is simulated (SD blocks, I2C bytes and decoder transfers advance the
+ * clock), the SD blocks and I2C bytes of each path are counted. See 'make bench'.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <Arduino.h>
+#include <Adafruit_Trellis.h>
+#include <Adafruit_VS1053.h>
+#include <ClickEncoder.h>
+#include <PN532Device.h>
+#include "Matrix.h"
+#include "Player.h"
+#include "NfcReader.h"
+
+#define TRACK_SIZE   16384    // 1s of audio
+#define TIMEOUT      10000    // [ms]
+
+void setup();
+void loop();
+extern ClickEncoder encoder;
+
+HT16K33* trellis;
+PN532Device* pn532;
+int entries;
+int tracks;
+
+
+struct Measure {
+  unsigned long start;
+  uint32_t blocks;
+  uint32_t i2cBytes;
+};
+
+Measure begin() {
+  Measure m = { micros(), SD.stats.blocks, Wire.stats.bytesWritten + Wire.stats.bytesRead };
+  return m;
+}
+
+void report(const char* path, const Measure& m, unsigned long end) {
+  printf("%s,%d,%d,%lu,%u,%u\n", path, entries, tracks, end - m.start,
+         SD.stats.blocks - m.blocks, Wire.stats.bytesWritten + Wire.stats.bytesRead - m.i2cBytes);
+}
+
+void run(unsigned long ms) {
+  unsigned long end = millis() + ms;
+  while ((long)(millis() - end) < 0) {
+    loop();
+  }
+}
+
+/*
+ * Run until a new track got its first data, the time of that data.
+ */
+unsigned long runUntilFed(uint32_t tracksBefore) {
+  VS1053Stats& stats = Adafruit_VS1053::instance->stats;
+  unsigned long end = millis() + TIMEOUT;
+  while (stats.tracks == tracksBefore || stats.firstDataMicros == 0) {
+    if ((long)(millis() - end) >= 0) {
+      fprintf(stderr, "No data fed: %s\n", Serial.output());
+      exit(1);
+    }
+    loop();
+  }
+  return stats.firstDataMicros;
+}
+
+void writeCard() {
+  SD.mount("sd/LatencyBench");
+  SD.mkdir("ALBUM");
+  byte data[TRACK_SIZE];
+  for (int i = 0; i < TRACK_SIZE; i++) data[i] = i;
+  for (int t = 0; t < tracks; t++) {
+    char name[20];
+    snprintf(name, sizeof(name), "ALBUM/T%03d.MP3", t);
+    File file = SD.open(name, FILE_WRITE);
+    file.write(data, sizeof(data));
+    file.close();
+  }
+
+  File file = SD.open("buttons.cfg", FILE_WRITE);
+  file.write("0=ALBUM\n");
+  file.close();
+  file = SD.open("nfc.cfg", FILE_WRITE);
+  for (int n = 0; n < entries; n++) {
+    char line[40];
+    snprintf(line, sizeof(line), "%08X=ALBUM\n", 0x04000000 + n * 7919);
+    file.write(line);
+  }
+  file.close();
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    printf("path,entries,tracks,micros,sdBlocks,i2cBytes\n");
+    return 0;
+  }
+  entries = atoi(argv[1]);
+  tracks = atoi(argv[2]);
+  writeCard();
+  setPin(HEADPHONE_LEVEL_PIN, 890);    // unplugged
+  trellis = new HT16K33(TRELLIS_ADDRESS);
+  trellis->connectInterrupt(TRELLIS_INT_PIN);
+  pn532 = new PN532Device(NFC_IRQ_PIN);
+
+  // startup with the index of nfc.cfg built
+  Measure m = begin();
+  setup();
+  report("boot", m, micros());
+  run(2000);
+  VS1053Stats& stats = Adafruit_VS1053::instance->stats;
+
+  // first press of the album key, its track list is built
+  m = begin();
+  trellis->press(0);
+  report("key", m, runUntilFed(stats.tracks));
+  run(100);
+  trellis->release(0);
+  run(100);
+
+  // same key again for the next track
+  if (tracks > 1) {
+    m = begin();
+    trellis->press(0);
+    report("next", m, runUntilFed(stats.tracks));
+    run(100);
+    trellis->release(0);
+  }
+
+  // stop and wait for nfc polling
+  encoder.press(ClickEncoder::Held);
+  run(100);
+  encoder.press(ClickEncoder::Released);
+  run(2000);
+
+  // tag in the middle of nfc.cfg
+  uint32_t id = 0x04000000 + entries / 2 * 7919;
+  uint8_t uid[] = { (uint8_t)(id >> 24), (uint8_t)(id >> 16), (uint8_t)(id >> 8), (uint8_t)id };
+  m = begin();
+  pn532->present(uid, sizeof(uid));
+  report("nfc", m, runUntilFed(stats.tracks));
+  pn532->remove();
+  return 0;
+}
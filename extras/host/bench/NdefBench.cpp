@@ -0,0 +1,107 @@
+/*
+ * Host benchmark of decoding an NDEF message read from a tag, NdefMessage (type, id
+ * and payload of each record copied to the heap, once more by getRecord()) against
+ * NdefMessageView (pointers into the tag buffer). Linked with the heap of the AVR
+ * (stubs/Heap.cpp), one csv line per message and parser (see 'make bench'):
+ * heap calls and bytes per message, highest break and the time on the host.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <chrono>
+#include <Arduino.h>
+#include <Heap.h>
+#include <NdefMessage.h>
+#include <NdefMessageView.h>
+
+#define ITERATIONS   100000
+
+byte buffer[256];
+int length;
+unsigned int records;
+volatile unsigned long sink;    // results used, not optimized away
+
+
+/*
+ * Encode the message like written on the tag (its records are freed before
+ * the heap is measured).
+ */
+void encode(NdefMessage& message) {
+  records = message.getRecordCount();
+  length = message.getEncodedSize();
+  message.encode(buffer);
+}
+
+void decodeMessage() {
+  NdefMessage message = NdefMessage(buffer, length);
+  sink += message.getRecordCount();
+}
+
+void decodeRecords() {
+  NdefMessage message = NdefMessage(buffer, length);
+  for (unsigned int i = 0; i < message.getRecordCount(); i++) {
+    sink += message.getRecord(i).getPayloadLength();
+  }
+}
+
+void decodeView() {
+  NdefMessageView message = NdefMessageView(buffer, length);
+  NdefRecordView record;
+  while (message.next(record)) {
+    sink += record.getPayloadLength();
+  }
+}
+
+void report(const char* name, const char* parser, void (*decode)()) {
+  Heap.reset();
+  auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < ITERATIONS; i++) {
+    decode();
+  }
+  auto end = std::chrono::steady_clock::now();
+  long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / ITERATIONS;
+  printf("%s,%s,%u,%d,%u,%u,%u,%u,%ld\n", name, parser, records, length,
+         Heap.stats.mallocs / ITERATIONS, Heap.stats.frees / ITERATIONS, Heap.stats.bytes / ITERATIONS,
+         Heap.stats.peak, ns);
+}
+
+void compare(const char* name) {
+  report(name, "NdefMessage", decodeMessage);
+  report(name, "NdefMessage+getRecord", decodeRecords);
+  report(name, "NdefMessageView", decodeView);
+}
+
+int main() {
+  printf("message,parser,records,bytes,mallocs,frees,heapBytes,peakHeap,hostNs\n");
+  {
+    NdefMessage message;
+    message.addUriRecord("GLOBI/ZOO");
+    encode(message);
+  }
+  compare("uri");
+  {
+    NdefMessage message;
+    message.addTextRecord("GLOBI/ZOO");
+    encode(message);
+  }
+  compare("text");
+  {
+    NdefMessage message;
+    message.addUriRecord("https://github.com/joergkeller/arduino-musicbox");
+    message.addTextRecord("GLOBI/ZOO");
+    message.addMimeMediaRecord("text/plain", "ALBUM/01.MP3");
+    encode(message);
+  }
+  compare("uri+text+mime");
+  {
+    NdefMessage message;
+    byte payload[200];
+    memset(payload, 'A', sizeof(payload));
+    message.addMimeMediaRecord("application/octet-stream", payload, sizeof(payload));
+    encode(message);
+  }
+  compare("mime 200 bytes");
+  return 0;
+}
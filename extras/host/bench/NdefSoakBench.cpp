@@ -0,0 +1,89 @@
+/*
+ * Host soak of reading tags with NfcAdapter from the emulated PN532, the records
+ * on the heap of the AVR (stubs/Heap.cpp) or in an NdefArena released after each tag:
+ *   NdefSoakBench <heap|arena> <reads>   csv line after reading <reads> tags
+ *   NdefSoakBench                        the csv header
+ * The tags hold messages of different size, each is read like by a sketch (message
+ * and its last record copied, the tag type is a String on the heap like on the Arduino).
+ * Reported are the heap calls, the highest break, the free bytes below the break
+ * (holes) at most and after the last read, and the peak of the arena. See 'make bench'.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <Arduino.h>
+#include <Heap.h>
+#include <PN532Device.h>
+#include <PN532_I2C.h>
+#include <PN532.h>
+#include <NfcAdapter.h>
+#include <vector>
+
+#define TAGS         8
+#define ARENA_SIZE   256
+
+PN532Device device(4);
+PN532_I2C pn532i2c(Wire);
+PN532 shield(pn532i2c);
+NfcAdapter nfc(shield);
+byte arenaBuffer[ARENA_SIZE];
+NdefArena arena(arenaBuffer, sizeof(arenaBuffer));
+
+std::vector<uint8_t> memories[TAGS];
+volatile unsigned long sink;    // results used, not optimized away
+
+
+/*
+ * Uri records with paths of 5 to 40 chars, every other tag with a text record
+ * in front (like written by a phone app).
+ */
+void createTags() {
+  for (byte t = 0; t < TAGS; t++) {
+    char path[48];
+    snprintf(path, sizeof(path), "ALBUM/%.*s", 5 * t, "GLOBI/ZOO/PINGU/BOND/PFOSCHTE/KIDS/01.MP3");
+    NdefMessage message;
+    if (t % 2) message.addTextRecord("musicbox");
+    message.addUriRecord(path);
+    byte encoded[128];
+    int length = message.getEncodedSize();
+    message.encode(encoded);
+    memories[t] = PN532Device::ultralight(encoded, length);
+  }
+}
+
+void readTag(bool useArena) {
+  if (!nfc.tagPresent()) return;
+  NfcTag tag = useArena ? nfc.read(arena) : nfc.read();
+  if (tag.hasNdefMessage()) {
+    NdefMessage message = tag.getNdefMessage();
+    NdefRecord record = message.getRecord(message.getRecordCount() - 1);
+    sink += record.getPayloadLength();
+  }
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    printf("allocator,reads,mallocs,failures,peakHeap,maxHoles,holes,arenaPeak,arenaFailures\n");
+    return 0;
+  }
+  bool useArena = strcmp(argv[1], "arena") == 0;
+  long reads = atol(argv[2]);
+
+  createTags();
+  Heap.reset();
+  nfc.begin(false);
+  uint8_t uid[] = { 0x04, 0x11, 0x22, 0x33, 0x44, 0x55, 0x00 };
+  for (long i = 0; i < reads; i++) {
+    uid[6] = i % TAGS;
+    device.present(uid, sizeof(uid), memories[i % TAGS]);
+    readTag(useArena);
+    arena.release();
+    device.remove();
+  }
+
+  printf("%s,%ld,%u,%u,%u,%u,%u,%u,%u\n", argv[1], reads, Heap.stats.mallocs, Heap.stats.failures,
+         Heap.stats.peak, Heap.stats.maxHoles, Heap.holes(), arena.getPeak(), arena.getFailures());
+  return 0;
+}
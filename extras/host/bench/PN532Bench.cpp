@@ -0,0 +1,89 @@
+/*
+ * Host benchmark of the I2C transactions per PN532 command against the emulated
+ * PN532, one csv line per command (see 'make bench'). The response of a command
+ * known to PN532_I2C is read in one request, an unknown one (GetGeneralStatus)
+ * takes the fallback with the header read and a NACK to get the frame again.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <Arduino.h>
+#include <PN532Device.h>
+#include <PN532_I2C.h>
+#include <PN532.h>
+
+PN532Device device(4);
+PN532_I2C pn532i2c(Wire);
+PN532 nfc(pn532i2c);
+
+const uint8_t UID4[] = { 0x04, 0xA1, 0xB2, 0xC3 };
+const uint8_t UID7[] = { 0x04, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 };
+
+WireStats before;
+PN532Stats deviceBefore;
+
+
+void begin() {
+  before = Wire.stats;
+  deviceBefore = device.stats;
+}
+
+void report(const char* command, bool success) {
+  printf("%s,%d,%u,%u,%u,%u\n", command, success,
+         Wire.stats.transmissions + Wire.stats.requests - before.transmissions - before.requests,
+         Wire.stats.bytesWritten + Wire.stats.bytesRead - before.bytesWritten - before.bytesRead,
+         Wire.stats.micros - before.micros, device.stats.nacks - deviceBefore.nacks);
+}
+
+bool autoPoll() {
+  if (!nfc.startAutoPoll(PN532_AUTOPOLL_ENDLESS, 1, PN532_AUTOPOLL_MIFARE)) return false;
+  uint8_t uid[7];
+  uint8_t length;
+  int8_t result;
+  while ((result = nfc.pollAutoPollTarget(uid, &length)) == PN532_PENDING) delay(1);
+  return result == 1;
+}
+
+int main() {
+  printf("command,success,transactions,bytes,busMicros,nacks\n");
+  nfc.begin();
+
+  begin();
+  report("GetFirmwareVersion", nfc.getFirmwareVersion() != 0);
+  begin();
+  report("SAMConfiguration", nfc.SAMConfig());
+
+  device.present(UID4, sizeof(UID4));
+  begin();
+  uint8_t uid[7];
+  uint8_t length;
+  report("InListPassiveTarget", nfc.readPassiveTargetID(PN532_MIFARE_ISO14443A, uid, &length));
+  begin();
+  report("InAutoPoll (4 byte uid)", autoPoll());
+  uint8_t block[16];
+  uint8_t key[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+  begin();
+  report("InDataExchange (authenticate)", nfc.mifareclassic_AuthenticateBlock(uid, length, 4, 0, key));
+  begin();
+  report("InDataExchange (read block)", nfc.mifareclassic_ReadDataBlock(4, block));
+
+  device.present(UID7, sizeof(UID7), PN532Device::ultralightUri("ALBUM"));
+  begin();
+  report("InAutoPoll (7 byte uid)", autoPoll());
+  begin();
+  report("InDataExchange (read 4 pages)", nfc.mifareultralight_ReadPage(4, block));
+  device.remove();
+
+  const uint8_t header[] = { 0x04 };
+  begin();
+  bool sent = nfc.beginCommand(header, sizeof(header)) == 0;
+  int16_t status;
+  while ((status = nfc.poll()) == PN532_PENDING) delay(1);
+  report("GetGeneralStatus (fallback)", sent && status >= 0);
+
+  begin();
+  report("PowerDown", nfc.powerDown(PN532_WAKEUP_I2C));
+  return 0;
+}
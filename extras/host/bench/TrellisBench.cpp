@@ -0,0 +1,89 @@
+/*
+ * Host benchmark of the I2C traffic of a minute of idle show on the emulated trellis:
+ *   TrellisBench <flush|full> <show>   csv line for the show (see Show.h)
+ *   TrellisBench                       the csv header
+ * flush: the show changes the frame buffer, Matrix::flush() writes the changed display
+ *        RAM bytes once per loop pass (as in the sketch)
+ * full:  writeDisplay() writes the whole display RAM in each loop pass the show changed
+ *        the frame buffer (as each LED change did before the frame buffer was flushed)
+ * The loop passes every millisecond (plus its time on the bus). Reported are the
+ * transactions, bytes (incl. the address byte) and time on the bus, and the frames
+ * shown by the HT16K33. See 'make bench'.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <Arduino.h>
+#include <Adafruit_Trellis.h>
+#include "Matrix.h"
+#include "Show.h"
+
+#define SHOW_MS   60000
+
+HT16K33 trellis(TRELLIS_ADDRESS);
+
+
+/*
+ * The idle show of the matrix, flushed once per loop pass.
+ */
+void runFlushed(const char* name) {
+  Matrix matrix;
+  matrix.initialize();
+  matrix.selectShow(name);
+  Wire.stats = WireStats();
+  trellis.frames.clear();
+  matrix.idle();
+  unsigned long end = millis() + SHOW_MS;
+  while ((long)(millis() - end) < 0) {
+    matrix.animate(millis());
+    matrix.flush();
+    delay(1);
+  }
+}
+
+/*
+ * The same show on boards written completely whenever their frame buffer changed.
+ */
+void runFull(const char* name) {
+  Trellis boards[TRELLIS_BOARDS];
+  Show show = Show(boards);
+  uint16_t shown[TRELLIS_BOARDS][TRELLIS_RAM_SIZE / 2];
+  for (byte b = 0; b < TRELLIS_BOARDS; b++) {
+    boards[b].begin(TRELLIS_ADDRESS + b);
+    boards[b].clear();
+    boards[b].writeDisplay();
+    memcpy(shown[b], boards[b].displaybuffer, sizeof(shown[b]));
+  }
+  show.select(name);
+  Wire.stats = WireStats();
+  trellis.frames.clear();
+  show.initialize(millis());
+  unsigned long end = millis() + SHOW_MS;
+  while ((long)(millis() - end) < 0) {
+    show.run(millis());
+    for (byte b = 0; b < TRELLIS_BOARDS; b++) {
+      if (memcmp(shown[b], boards[b].displaybuffer, sizeof(shown[b])) != 0) {
+        boards[b].writeDisplay();
+        memcpy(shown[b], boards[b].displaybuffer, sizeof(shown[b]));
+      }
+    }
+    delay(1);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    printf("writer,show,transactions,bytes,busMicros,frames\n");
+    return 0;
+  }
+  if (strcmp(argv[1], "full") == 0) {
+    runFull(argv[2]);
+  } else {
+    runFlushed(argv[2]);
+  }
+  printf("%s,%s,%u,%u,%u,%u\n", argv[1], argv[2], Wire.stats.transmissions + Wire.stats.requests,
+         Wire.stats.bytesWritten + Wire.stats.bytesRead, Wire.stats.micros, (unsigned int)trellis.frames.size());
+  return 0;
+}
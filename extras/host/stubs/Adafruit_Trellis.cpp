@@ -0,0 +1,209 @@
+/*
+ * Adafruit_Trellis library on the host, talking to an emulated HT16K33 over Wire.
+ * The HT16K33 records every frame it shows (LEDs, brightness, blink rate) with its
+ * time and scans the keys pressed by the test.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <Adafruit_Trellis.h>
+
+#define HT16K33_OSCILLATOR_OFF   0x20
+#define HT16K33_OSCILLATOR_ON    0x21
+#define HT16K33_KEY_RAM          0x40
+#define HT16K33_INT_FLAG         0x60
+#define HT16K33_INT_SET          0xA0
+
+const uint8_t Adafruit_Trellis::ledLUT[16] =
+  { 0x3A, 0x37, 0x35, 0x34,
+    0x28, 0x29, 0x23, 0x24,
+    0x16, 0x1B, 0x11, 0x10,
+    0x0E, 0x0D, 0x0C, 0x02 };
+const uint8_t Adafruit_Trellis::buttonLUT[16] =
+  { 0x07, 0x04, 0x02, 0x22,
+    0x05, 0x06, 0x00, 0x01,
+    0x03, 0x10, 0x30, 0x21,
+    0x13, 0x12, 0x11, 0x31 };
+
+
+void Adafruit_LEDBackpack::begin(uint8_t address) const {
+  i2c_addr = address;
+  Wire.begin();
+  command(HT16K33_OSCILLATOR_ON);
+  blinkRate(HT16K33_BLINK_OFF);
+  setBrightness(15);
+}
+
+void Adafruit_LEDBackpack::setBrightness(uint8_t b) const {
+  command(HT16K33_CMD_BRIGHTNESS | min(b, 15));
+}
+
+void Adafruit_LEDBackpack::blinkRate(uint8_t b) const {
+  if (b > 3) b = 0;
+  command(HT16K33_BLINK_CMD | HT16K33_BLINK_DISPLAYON | (b << 1));
+}
+
+void Adafruit_LEDBackpack::writeDisplay(void) const {
+  Wire.beginTransmission(i2c_addr);
+  Wire.write((uint8_t)0x00);
+  for (uint8_t i = 0; i < 8; i++) {
+    Wire.write(displaybuffer[i] & 0xFF);
+    Wire.write(displaybuffer[i] >> 8);
+  }
+  Wire.endTransmission();
+}
+
+void Adafruit_LEDBackpack::clear(void) const {
+  memset(displaybuffer, 0, sizeof(displaybuffer));
+}
+
+void Adafruit_LEDBackpack::command(uint8_t c) const {
+  Wire.beginTransmission(i2c_addr);
+  Wire.write(c);
+  Wire.endTransmission();
+}
+
+
+Adafruit_Trellis::Adafruit_Trellis(void) {
+  memset(displaybuffer, 0, sizeof(displaybuffer));
+  memset(keys, 0, sizeof(keys));
+  memset(lastKeys, 0, sizeof(lastKeys));
+  i2c_addr = 0x70;
+}
+
+void Adafruit_Trellis::begin(uint8_t address) const {
+  Adafruit_LEDBackpack::begin(address);
+  command(HT16K33_INT_SET | 0x01);   // interrupt active low
+}
+
+void Adafruit_Trellis::setLED(uint8_t x) const {
+  if (x > 15) return;
+  displaybuffer[ledLUT[x] >> 4] |= bit(ledLUT[x] & 0x0F);
+}
+
+void Adafruit_Trellis::clrLED(uint8_t x) const {
+  if (x > 15) return;
+  displaybuffer[ledLUT[x] >> 4] &= ~bit(ledLUT[x] & 0x0F);
+}
+
+bool Adafruit_Trellis::isLED(uint8_t x) const {
+  if (x > 15) return false;
+  return displaybuffer[ledLUT[x] >> 4] & bit(ledLUT[x] & 0x0F);
+}
+
+boolean Adafruit_Trellis::readSwitches(void) const {
+  memcpy(lastKeys, keys, sizeof(keys));
+  command(HT16K33_KEY_RAM);
+  Wire.requestFrom(i2c_addr, (uint8_t)6);
+  for (uint8_t i = 0; i < 6; i++) {
+    keys[i] = Wire.read();
+  }
+  return memcmp(lastKeys, keys, sizeof(keys)) != 0;
+}
+
+bool Adafruit_Trellis::isKeyPressed(uint8_t k) const {
+  if (k > 15) return false;
+  return keys[buttonLUT[k] >> 4] & bit(buttonLUT[k] & 0x0F);
+}
+
+bool Adafruit_Trellis::wasKeyPressed(uint8_t k) const {
+  if (k > 15) return false;
+  return lastKeys[buttonLUT[k] >> 4] & bit(buttonLUT[k] & 0x0F);
+}
+
+boolean Adafruit_Trellis::justPressed(uint8_t k) const {
+  return isKeyPressed(k) && !wasKeyPressed(k);
+}
+
+boolean Adafruit_Trellis::justReleased(uint8_t k) const {
+  return !isKeyPressed(k) && wasKeyPressed(k);
+}
+
+void Adafruit_Trellis::sleep(void) const {
+  command(HT16K33_OSCILLATOR_OFF);
+}
+
+void Adafruit_Trellis::wakeup(void) const {
+  command(HT16K33_OSCILLATOR_ON);
+}
+
+
+HT16K33::HT16K33(uint8_t address) {
+  memset(ram, 0, sizeof(ram));
+  memset(keyRam, 0, sizeof(keyRam));
+  Wire.attach(address, this);
+}
+
+/*
+ * A write starts with a command or the display RAM address followed by its data.
+ */
+void HT16K33::receive(uint8_t address, const uint8_t* data, uint8_t length) {
+  if (length == 0) return;
+  uint8_t c = data[0];
+  if (c < sizeof(ram)) {
+    for (uint8_t i = 1; i < length; i++) {
+      ram[(c + i - 1) % sizeof(ram)] = data[i];
+    }
+  } else if ((c & 0xFE) == HT16K33_OSCILLATOR_OFF) {
+    oscillator = c & 0x01;
+  } else if ((c & 0xF0) == HT16K33_BLINK_CMD) {
+    blinkRate = (c >> 1) & 0x03;
+  } else if ((c & 0xF0) == HT16K33_CMD_BRIGHTNESS) {
+    brightness = c & 0x0F;
+  }
+  pointer = c;
+  record();
+}
+
+/*
+ * Read the key RAM (clears the key flag) or the key flag, as addressed by the last write.
+ */
+uint8_t HT16K33::request(uint8_t address, uint8_t* data, uint8_t length) {
+  for (uint8_t i = 0; i < length; i++) {
+    if (pointer == HT16K33_INT_FLAG) {
+      data[i] = keyFlag;
+    } else {
+      data[i] = i < sizeof(keyRam) ? keyRam[i] : 0;
+    }
+  }
+  if (pointer == HT16K33_KEY_RAM) keyFlag = 0;
+  return length;
+}
+
+uint16_t HT16K33::leds() {
+  uint16_t mask = 0;
+  for (uint8_t k = 0; k < 16; k++) {
+    uint8_t led = Adafruit_Trellis::ledLUT[k];
+    if (ram[2 * (led >> 4) + ((led & 0x0F) >> 3)] & bit(led & 0x07)) mask |= bit(k);
+  }
+  return mask;
+}
+
+void HT16K33::press(uint8_t key) {
+  uint8_t button = Adafruit_Trellis::buttonLUT[key];
+  keyRam[button >> 4] |= bit(button & 0x0F);
+  keyFlag = 0xFF;
+  if (interruptPin >= 0) triggerInterrupt(interruptPin);
+}
+
+void HT16K33::release(uint8_t key) {
+  uint8_t button = Adafruit_Trellis::buttonLUT[key];
+  keyRam[button >> 4] &= ~bit(button & 0x0F);
+  keyFlag = 0xFF;
+  if (interruptPin >= 0) triggerInterrupt(interruptPin);
+}
+
+/*
+ * Record the frame when it changed (only while the oscillator runs).
+ */
+void HT16K33::record() {
+  TrellisFrame frame = { millis(), leds(), brightness, blinkRate };
+  if (!oscillator) frame.leds = 0;
+  if (!frames.empty()) {
+    const TrellisFrame& last = frames.back();
+    if (last.leds == frame.leds && last.brightness == frame.brightness && last.blinkRate == frame.blinkRate) return;
+  }
+  frames.push_back(frame);
+}
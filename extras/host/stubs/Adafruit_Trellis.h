@@ -0,0 +1,103 @@
+/*
+ * Adafruit_Trellis library on the host, talking to an emulated HT16K33 over Wire.
+ * The HT16K33 records every frame it shows (LEDs, brightness, blink rate) with its
+ * time and scans the keys pressed by the test.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef Adafruit_Trellis_h
+#define Adafruit_Trellis_h
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <vector>
+
+#define HT16K33_BLINK_CMD        0x80
+#define HT16K33_BLINK_DISPLAYON  0x01
+#define HT16K33_BLINK_OFF        0
+#define HT16K33_BLINK_2HZ        1
+#define HT16K33_BLINK_1HZ        2
+#define HT16K33_BLINK_HALFHZ     3
+#define HT16K33_CMD_BRIGHTNESS   0xE0
+
+
+class Adafruit_LEDBackpack {
+  public:
+    void begin(uint8_t address = 0x70) const;
+    void setBrightness(uint8_t b) const;
+    void blinkRate(uint8_t b) const;
+    void writeDisplay(void) const;
+    void clear(void) const;
+
+    mutable uint16_t displaybuffer[8];
+
+  protected:
+    mutable uint8_t i2c_addr;
+    void command(uint8_t c) const;
+};
+
+
+class Adafruit_Trellis : public Adafruit_LEDBackpack {
+  public:
+    Adafruit_Trellis(void);
+    void begin(uint8_t address = 0x70) const;
+
+    void setLED(uint8_t x) const;
+    void clrLED(uint8_t x) const;
+    bool isLED(uint8_t x) const;
+
+    boolean readSwitches(void) const;
+    bool isKeyPressed(uint8_t k) const;
+    bool wasKeyPressed(uint8_t k) const;
+    boolean justPressed(uint8_t k) const;
+    boolean justReleased(uint8_t k) const;
+
+    void sleep(void) const;
+    void wakeup(void) const;
+
+    mutable uint8_t keys[6], lastKeys[6];
+
+    static const uint8_t ledLUT[16];
+    static const uint8_t buttonLUT[16];
+};
+
+
+struct TrellisFrame {
+  unsigned long millis;
+  uint16_t leds;        // bit per key
+  byte brightness;
+  byte blinkRate;
+};
+
+/*
+ * Emulated HT16K33 of a trellis board (host only), attached to Wire at its address.
+ */
+class HT16K33 : public WireDevice {
+  public:
+    HT16K33(uint8_t address = 0x70);
+
+    void receive(uint8_t address, const uint8_t* data, uint8_t length);
+    uint8_t request(uint8_t address, uint8_t* data, uint8_t length);
+
+    uint16_t leds();
+    void press(uint8_t key);      // signals the INT line when connected
+    void release(uint8_t key);
+    void connectInterrupt(uint8_t pin) { interruptPin = pin; }
+
+    std::vector<TrellisFrame> frames;
+    uint8_t ram[16];
+    uint8_t keyRam[6];
+    uint8_t keyFlag = 0;
+    uint8_t pointer = 0;
+    byte brightness = 15;
+    byte blinkRate = HT16K33_BLINK_OFF;
+    bool oscillator = false;
+
+  private:
+    int interruptPin = -1;
+    void record();
+};
+
+#endif
@@ -0,0 +1,167 @@
+/*
+ * Adafruit_VS1053 library on the host, an emulated decoder with its 2048 byte FIFO.
+ * The FIFO drains at the bitrate of the track once data arrived, DREQ is high while
+ * at least 32 bytes are free. Each change of DREQ calls the pin change interrupt
+ * (PCINT0_vect of the sketch) when enabled in PCICR/PCMSK0. The bytes fed, the time
+ * of the first data after a reset of the decode time and the underruns are counted
+ * in stats.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <Adafruit_VS1053.h>
+
+// SPI transfer of a data byte at 4 MHz (incl. chip select)
+#define VS1053_BYTE_MICROS   2
+
+// Pin change interrupt of the sketch (if any)
+void PCINT0_vect() __attribute__((weak));
+
+Adafruit_VS1053* Adafruit_VS1053::instance = NULL;
+
+
+Adafruit_VS1053::Adafruit_VS1053(int8_t rst, int8_t cs, int8_t dcs, int8_t dreq)
+: dreq(dreq) {
+  memset(&stats, 0, sizeof(stats));
+  memset(registers, 0, sizeof(registers));
+  instance = this;
+  addClockListener(onClock);
+}
+
+/*
+ * Pin change interrupt on each change of DREQ.
+ */
+void Adafruit_VS1053::onClock() {
+  Adafruit_VS1053* codec = instance;
+  if (!codec) return;
+  bool ready = codec->readyForData();
+  if (ready == codec->request) return;
+  codec->request = ready;
+  if (PCINT0_vect && (PCICR & bit(0)) && (PCMSK0 & bit(digitalPinToPCMSKbit(codec->dreq)))) {
+    codec->interrupts++;
+    PCINT0_vect();
+  }
+}
+
+uint8_t Adafruit_VS1053::begin(void) {
+  reset();
+  return 4;   // VS1053
+}
+
+void Adafruit_VS1053::reset(void) {
+  softReset();
+}
+
+void Adafruit_VS1053::softReset(void) {
+  level = 0;
+  playing = false;
+}
+
+void Adafruit_VS1053::setVolume(uint8_t left, uint8_t right) {
+  volume = left;
+}
+
+/*
+ * DREQ: space for at least 32 bytes in the FIFO.
+ */
+boolean Adafruit_VS1053::readyForData(void) {
+  drain();
+  return VS1053_FIFO_SIZE - level >= VS1053_DATABUFFERLEN;
+}
+
+void Adafruit_VS1053::playData(uint8_t* buffer, uint8_t buffsiz) {
+  drain();
+  if (stats.firstDataMicros == 0) stats.firstDataMicros = max(1UL, micros());
+  level = min(VS1053_FIFO_SIZE, level + buffsiz);
+  stats.bytesFed += buffsiz;
+  stats.playCalls++;
+  stats.maxFill = max(stats.maxFill, level);
+  playing = true;
+  advanceMicros(VS1053_BYTE_MICROS * buffsiz);
+}
+
+uint16_t Adafruit_VS1053::sciRead(uint8_t addr) {
+  return registers[addr & 0x0F];
+}
+
+/*
+ * Writing the decode time starts a track (see Player::startPlayingFile()), a cancel ends it.
+ */
+void Adafruit_VS1053::sciWrite(uint8_t addr, uint16_t data) {
+  registers[addr & 0x0F] = data;
+  if (addr == VS1053_REG_DECODETIME && data == 0) {
+    startTrack();
+  } else if (addr == VS1053_REG_MODE && (data & VS1053_MODE_SM_CANCEL)) {
+    level = 0;
+    playing = false;
+  }
+}
+
+uint16_t Adafruit_VS1053::decodeTime(void) {
+  return registers[VS1053_REG_DECODETIME];
+}
+
+uint16_t Adafruit_VS1053::fill() {
+  drain();
+  return level;
+}
+
+void Adafruit_VS1053::startTrack() {
+  if (stats.firstDataMicros != 0 || stats.tracks == 0) stats.tracks++;
+  stats.firstDataMicros = 0;
+  level = 0;
+  playing = false;
+}
+
+/*
+ * Decode the FIFO since the last call at the bitrate, the time of a partial byte
+ * is kept for the next call.
+ */
+void Adafruit_VS1053::drain() {
+  unsigned long now = micros();
+  if (!playing) {
+    drained = now;
+    return;
+  }
+  unsigned long decoded = (uint32_t)(now - drained) * VS1053_BYTES_PER_MS / 1000;
+  drained += decoded * 1000 / VS1053_BYTES_PER_MS;
+  if (decoded >= level) {
+    level = 0;
+    stats.underruns++;
+    playing = false;   // resumes with the next data
+  } else {
+    level -= decoded;
+  }
+  if (stats.minFill == 0 || level < stats.minFill) stats.minFill = level;
+}
+
+
+Adafruit_VS1053_FilePlayer::Adafruit_VS1053_FilePlayer(int8_t rst, int8_t cs, int8_t dcs, int8_t dreq, int8_t cardCS)
+: Adafruit_VS1053(rst, cs, dcs, dreq) {}
+
+boolean Adafruit_VS1053_FilePlayer::begin(void) {
+  return Adafruit_VS1053::begin() == 4;
+}
+
+boolean Adafruit_VS1053_FilePlayer::isMP3File(const char* fileName) {
+  const char* dot = strrchr(fileName, '.');
+  return dot && strcasecmp(dot, ".mp3") == 0;
+}
+
+/*
+ * Skip an ID3v2 tag at the start of the file.
+ */
+unsigned long Adafruit_VS1053_FilePlayer::mp3_ID3Jumper(File mp3) {
+  byte header[10];
+  unsigned long start = 0;
+  mp3.seek(0);
+  if (mp3.read(header, sizeof(header)) == sizeof(header) && memcmp(header, "ID3", 3) == 0) {
+    start = ((unsigned long)(header[6] & 0x7F) << 21) | ((unsigned long)(header[7] & 0x7F) << 14)
+        | ((header[8] & 0x7F) << 7) | (header[9] & 0x7F);
+    start += sizeof(header);
+  }
+  mp3.seek(0);
+  return start;
+}
@@ -0,0 +1,102 @@
+/*
+ * Adafruit_VS1053 library on the host, an emulated decoder with its 2048 byte FIFO.
+ * The FIFO drains at the bitrate of the track once data arrived, DREQ is high while
+ * at least 32 bytes are free. Each change of DREQ calls the pin change interrupt
+ * (PCINT0_vect of the sketch) when enabled in PCICR/PCMSK0. The bytes fed, the time
+ * of the first data after a reset of the decode time and the underruns are counted
+ * in stats.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef ADAFRUIT_VS1053_H
+#define ADAFRUIT_VS1053_H
+
+#include <Arduino.h>
+#include <SD.h>
+
+#define VS1053_FILEPLAYER_TIMER0_INT   255
+#define VS1053_FILEPLAYER_PIN_INT        5
+#define VS1053_DATABUFFERLEN            32
+
+#define VS1053_REG_MODE         0x00
+#define VS1053_REG_STATUS       0x01
+#define VS1053_REG_CLOCKF       0x03
+#define VS1053_REG_DECODETIME   0x04
+#define VS1053_REG_AUDATA       0x05
+#define VS1053_REG_WRAM         0x06
+#define VS1053_REG_WRAMADDR     0x07
+#define VS1053_REG_VOLUME       0x0B
+
+#define VS1053_MODE_SM_DIFF      0x0001
+#define VS1053_MODE_SM_LAYER12   0x0002
+#define VS1053_MODE_SM_RESET     0x0004
+#define VS1053_MODE_SM_CANCEL    0x0008
+#define VS1053_MODE_SM_TESTS     0x0020
+#define VS1053_MODE_SM_SDINEW    0x0800
+#define VS1053_MODE_SM_LINE1     0x4000
+
+#define VS1053_FIFO_SIZE     2048
+#define VS1053_BYTES_PER_MS    16    // 128 kbit/s
+
+
+struct VS1053Stats {
+  uint32_t bytesFed;
+  uint32_t playCalls;
+  uint32_t tracks;            // decode time reset
+  uint32_t firstDataMicros;   // of the current track, 0 = no data yet
+  uint32_t underruns;         // FIFO ran empty while playing
+  uint16_t minFill;           // lowest FIFO fill while playing
+  uint16_t maxFill;
+};
+
+
+class Adafruit_VS1053 {
+  public:
+    Adafruit_VS1053(int8_t rst, int8_t cs, int8_t dcs, int8_t dreq);
+    uint8_t begin(void);
+    void reset(void);
+    void softReset(void);
+    void setVolume(uint8_t left, uint8_t right);
+    void sineTest(uint8_t n, uint16_t ms) {}
+    boolean readyForData(void);
+    void playData(uint8_t* buffer, uint8_t buffsiz);
+    uint16_t sciRead(uint8_t addr);
+    void sciWrite(uint8_t addr, uint16_t data);
+    uint16_t decodeTime(void);
+
+    uint16_t fill();          // host only
+    void startTrack();        // host only, count as track start
+    VS1053Stats stats;        // host only
+    uint8_t volume = 0;       // host only
+    uint32_t interrupts = 0;  // host only, pin change interrupts of DREQ
+    static Adafruit_VS1053* instance;   // host only, the last one constructed
+
+  protected:
+    int8_t dreq;
+
+  private:
+    uint16_t level = 0;
+    bool playing = false;
+    unsigned long drained = 0;   // micros of the last drain
+    uint16_t registers[16];
+    bool request = false;        // DREQ at the last clock tick
+
+    void drain();
+    static void onClock();
+};
+
+
+class Adafruit_VS1053_FilePlayer : public Adafruit_VS1053 {
+  public:
+    Adafruit_VS1053_FilePlayer(int8_t rst, int8_t cs, int8_t dcs, int8_t dreq, int8_t cardCS);
+    boolean begin(void);
+    boolean useInterrupt(uint8_t type) { return true; }
+    boolean stopped(void) { return true; }
+
+    static boolean isMP3File(const char* fileName);
+    unsigned long mp3_ID3Jumper(File mp3);
+};
+
+#endif
@@ -0,0 +1,230 @@
+/*
+ * Minimal Arduino core to build the music box classes on the host (see README.md, host tests).
+ * Time only advances when the test sets it (setMillis/advanceMicros) or calls delay(),
+ * the devices listening to the clock may raise interrupts then.
+ * Serial output is collected in a buffer, echoed to stdout when HOST_SERIAL is set.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <Arduino.h>
+
+HardwareSerial Serial;
+volatile uint8_t PCMSK0, PCICR, PCIFR;
+
+static unsigned long long clockMicros = 0;
+static int pins[NUM_PINS];
+static PinSource* sources[NUM_PINS];
+static void (*handlers[NUM_PINS])(void);
+static void (*listeners[4])(void);
+static bool interruptsEnabled = true;
+static bool inInterrupt = false;
+
+
+/*
+ * Let the devices follow the clock (not nested, like an interrupt).
+ */
+static void tick() {
+  if (!interruptsEnabled || inInterrupt) return;
+  inInterrupt = true;
+  for (byte i = 0; i < sizeof(listeners) / sizeof(listeners[0]) && listeners[i]; i++) {
+    listeners[i]();
+  }
+  inInterrupt = false;
+}
+
+void addClockListener(void (*listener)(void)) {
+  for (byte i = 0; i < sizeof(listeners) / sizeof(listeners[0]); i++) {
+    if (!listeners[i] || listeners[i] == listener) {
+      listeners[i] = listener;
+      return;
+    }
+  }
+}
+
+
+/*
+ * 32 bit like on the AVR, wrapping around after ~49 days (millis) or ~71 minutes (micros).
+ */
+unsigned long millis() {
+  return (uint32_t)(clockMicros / 1000);
+}
+
+unsigned long micros() {
+  return (uint32_t)clockMicros;
+}
+
+void delay(unsigned long ms) {
+  clockMicros += 1000ULL * ms;
+  tick();
+}
+
+void delayMicroseconds(unsigned int us) {
+  clockMicros += us;
+  tick();
+}
+
+/*
+ * Set the clock, millis() wraps around like on the AVR (32 bit).
+ */
+void setMillis(unsigned long ms) {
+  clockMicros = 1000ULL * (uint32_t)ms;
+}
+
+void advanceMicros(unsigned long us) {
+  clockMicros += us;
+  tick();
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin < NUM_PINS && mode == INPUT_PULLUP) pins[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  if (pin < NUM_PINS) pins[pin] = value;
+}
+
+int digitalRead(uint8_t pin) {
+  if (pin >= NUM_PINS) return LOW;
+  return sources[pin] ? sources[pin]->readPin(pin) : pins[pin];
+}
+
+int analogRead(uint8_t pin) {
+  return pin < NUM_PINS ? pins[pin] : 0;
+}
+
+void setPin(uint8_t pin, int value) {
+  if (pin < NUM_PINS) pins[pin] = value;
+}
+
+void setPinSource(uint8_t pin, PinSource* source) {
+  if (pin < NUM_PINS) sources[pin] = source;
+}
+
+void attachInterrupt(uint8_t interrupt, void (*isr)(void), int mode) {
+  if (interrupt < NUM_PINS) handlers[interrupt] = isr;
+}
+
+void detachInterrupt(uint8_t interrupt) {
+  if (interrupt < NUM_PINS) handlers[interrupt] = NULL;
+}
+
+void triggerInterrupt(uint8_t interrupt) {
+  if (interrupt < NUM_PINS && handlers[interrupt]) handlers[interrupt]();
+}
+
+void noInterrupts() {
+  interruptsEnabled = false;
+}
+
+void interrupts() {
+  interruptsEnabled = true;
+  tick();
+}
+
+/*
+ * Digits as printed by avr-libc (lower case) or Print (upper case).
+ */
+static char* format(unsigned long value, bool negative, char* buffer, int base, char letters = 'a') {
+  char digits[34];
+  byte n = 0;
+  do {
+    byte digit = value % base;
+    digits[n++] = digit < 10 ? '0' + digit : letters + digit - 10;
+    value /= base;
+  } while (value > 0);
+  char* p = buffer;
+  if (negative) *p++ = '-';
+  while (n > 0) *p++ = digits[--n];
+  *p = '\0';
+  return buffer;
+}
+
+char* ltoa(long value, char* buffer, int base) {
+  bool negative = value < 0 && base == 10;
+  return format(negative ? -(unsigned long)value : (unsigned long)value, negative, buffer, base);
+}
+
+char* itoa(int value, char* buffer, int base) {
+  if (base != 10) return format((unsigned int)value, false, buffer, base);
+  return ltoa(value, buffer, base);
+}
+
+char* utoa(unsigned int value, char* buffer, int base) {
+  return format(value, false, buffer, base);
+}
+
+
+String::Chars String::format(unsigned long value, unsigned char base) {
+  char buffer[34];
+  return ::format(value, false, buffer, base);
+}
+
+String::Chars String::format(long value, unsigned char base) {
+  char buffer[34];
+  return ltoa(value, buffer, base);
+}
+
+void String::trim() {
+  size_t start = 0;
+  while (start < s.size() && isspace(s[start])) start++;
+  size_t end = s.size();
+  while (end > start && isspace(s[end - 1])) end--;
+  s = s.substr(start, end - start);
+}
+
+void String::toUpperCase() {
+  for (size_t i = 0; i < s.size(); i++) s[i] = toupper(s[i]);
+}
+
+void String::toLowerCase() {
+  for (size_t i = 0; i < s.size(); i++) s[i] = tolower(s[i]);
+}
+
+void String::getBytes(unsigned char* buffer, unsigned int size) const {
+  if (size == 0) return;
+  unsigned int n = min(size - 1, (unsigned int)s.size());
+  memcpy(buffer, s.data(), n);
+  buffer[n] = '\0';
+}
+
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (size--) n += write(*buffer++);
+  return n;
+}
+
+size_t Print::print(long value, int base) {
+  char buffer[34];
+  if (base != 10) return write(format((unsigned long)value, false, buffer, base, 'A'));
+  return write(ltoa(value, buffer, base));
+}
+
+size_t Print::print(unsigned long value, int base) {
+  char buffer[34];
+  return write(format(value, false, buffer, base, 'A'));
+}
+
+size_t Print::print(double value, int digits) {
+  char buffer[40];
+  snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+  return write(buffer);
+}
+
+
+size_t HardwareSerial::write(uint8_t c) {
+  static const bool echo = getenv("HOST_SERIAL") != NULL;
+  out += (char)c;
+  if (echo) putchar(c);
+  return 1;
+}
+
+int HardwareSerial::read() {
+  if (input.empty()) return -1;
+  byte c = input[0];
+  input.erase(0, 1);
+  return c;
+}
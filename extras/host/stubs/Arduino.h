@@ -0,0 +1,260 @@
+/*
+ * Minimal Arduino core to build the music box classes on the host (see README.md, host tests).
+ * Time only advances when the test sets it (setMillis/advanceMicros) or calls delay().
+ * Serial output is collected in a buffer, echoed to stdout when HOST_SERIAL is set.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <string>
+#include <type_traits>
+
+#define ARDUINO   10819
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef unsigned int word;
+
+#define HIGH           1
+#define LOW            0
+#define INPUT          0x0
+#define OUTPUT         0x1
+#define INPUT_PULLUP   0x2
+
+#define CHANGE         1
+#define FALLING        2
+#define RISING         3
+
+#define DEC   10
+#define HEX   16
+#define OCT    8
+#define BIN    2
+
+#define A0   18
+#define A1   19
+#define A2   20
+#define A3   21
+#define A4   22
+#define A5   23
+#define NUM_PINS   24
+
+// Flash access, the host has a single address space
+#define PROGMEM
+#define PSTR(s)                  (s)
+#define pgm_read_byte(p)         (*(const uint8_t*)(p))
+#define pgm_read_word(p)         (*(const uint16_t*)(p))
+#define pgm_read_dword(p)        (*(const uint32_t*)(p))
+#define pgm_read_ptr(p)          (*(void* const*)(p))
+#define pgm_read_byte_near(p)    pgm_read_byte(p)
+#define pgm_read_word_near(p)    pgm_read_word(p)
+#define pgm_read_byte_far(p)     pgm_read_byte(p)
+#define pgm_read_word_far(p)     pgm_read_word(p)
+#define memcpy_P                 memcpy
+#define strcmp_P                 strcmp
+#define strcpy_P                 strcpy
+#define strlen_P                 strlen
+
+class __FlashStringHelper;
+#define F(s)   (reinterpret_cast<const __FlashStringHelper*>(s))
+
+#define bit(b)            (1UL << (b))
+#define bitRead(v, b)     (((v) >> (b)) & 0x01)
+#define bitSet(v, b)      ((v) |= (1UL << (b)))
+#define bitClear(v, b)    ((v) &= ~(1UL << (b)))
+#define lowByte(w)        ((uint8_t)((w) & 0xff))
+#define highByte(w)       ((uint8_t)((w) >> 8))
+
+template <class A, class B> inline typename std::common_type<A, B>::type min(A a, B b) { return a < b ? a : b; }
+template <class A, class B> inline typename std::common_type<A, B>::type max(A a, B b) { return a < b ? b : a; }
+template <class T, class L, class H> inline T constrain(T x, L low, H high) { return x < low ? low : (x > high ? high : x); }
+
+// Time
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void setMillis(unsigned long ms);         // host only
+void advanceMicros(unsigned long us);     // host only
+void addClockListener(void (*listener)(void));   // host only, called after the clock advanced
+
+// Pins, an input reads the level set by setPin() (pullups read HIGH) or by its source
+class PinSource {
+  public:
+    virtual ~PinSource() {}
+    virtual int readPin(uint8_t pin) = 0;
+};
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void setPin(uint8_t pin, int value);      // host only
+void setPinSource(uint8_t pin, PinSource* source);   // host only, e.g. the irq pin of a device
+
+// Interrupts, an attached handler is called by triggerInterrupt(), clock listeners
+// (the devices raising interrupts) are not called while interrupts are disabled
+#define digitalPinToInterrupt(p)   (p)
+void attachInterrupt(uint8_t interrupt, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t interrupt);
+void triggerInterrupt(uint8_t interrupt);   // host only
+void noInterrupts();
+void interrupts();
+#define ISR(vector)   void vector()
+
+// Pin change interrupt registers of the 32u4
+extern volatile uint8_t PCMSK0, PCICR, PCIFR;
+#define digitalPinToPCMSK(p)      (&PCMSK0)
+#define digitalPinToPCMSKbit(p)   ((p) & 0x07)
+#define digitalPinToPCICRbit(p)   0
+
+char* itoa(int value, char* buffer, int base);
+char* ltoa(long value, char* buffer, int base);
+char* utoa(unsigned int value, char* buffer, int base);
+
+
+/*
+ * The chars of a String are allocated with malloc() like on the Arduino (the heap
+ * of the AVR with HEAP_FLAGS), only short strings are kept in the object by std::string.
+ */
+template <class T> struct MallocAllocator {
+  typedef T value_type;
+  MallocAllocator() {}
+  template <class U> MallocAllocator(const MallocAllocator<U>& other) {}
+  T* allocate(size_t n) { return (T*)malloc(n * sizeof(T)); }
+  void deallocate(T* p, size_t n) { free(p); }
+  bool operator==(const MallocAllocator& other) const { return true; }
+  bool operator!=(const MallocAllocator& other) const { return false; }
+};
+
+class String {
+  public:
+    String(const char* s = "") : s(s ? s : "") {}
+    String(const __FlashStringHelper* s) : s(reinterpret_cast<const char*>(s)) {}
+    String(const std::string& s) : s(s.c_str(), s.size()) {}
+    explicit String(char c) : s(1, c) {}
+    explicit String(unsigned char value, unsigned char base = DEC) : s(format(value, base)) {}
+    explicit String(int value, unsigned char base = DEC) : s(format(value, base)) {}
+    explicit String(unsigned int value, unsigned char base = DEC) : s(format(value, base)) {}
+    explicit String(long value, unsigned char base = DEC) : s(format(value, base)) {}
+    explicit String(unsigned long value, unsigned char base = DEC) : s(format(value, base)) {}
+
+    unsigned int length() const { return s.size(); }
+    const char* c_str() const { return s.c_str(); }
+    char charAt(unsigned int i) const { return i < s.size() ? s[i] : 0; }
+    char operator[](unsigned int i) const { return charAt(i); }
+    bool reserve(unsigned int size) { s.reserve(size); return true; }
+
+    String& operator+=(const String& other) { s += other.s; return *this; }
+    String& operator+=(const char* other) { s += other; return *this; }
+    String& operator+=(char c) { s += c; return *this; }
+    bool concat(const String& other) { s += other.s; return true; }
+    friend String operator+(const String& a, const String& b) { return String(a.s + b.s); }
+    friend String operator+(const String& a, const char* b) { return String(a.s + b); }
+    friend String operator+(const String& a, char b) { return String(a.s + b); }
+
+    bool operator==(const String& other) const { return s == other.s; }
+    bool operator==(const char* other) const { return s == other; }
+    bool operator!=(const String& other) const { return s != other.s; }
+    bool equals(const String& other) const { return s == other.s; }
+    bool startsWith(const String& prefix) const { return s.compare(0, prefix.s.size(), prefix.s) == 0; }
+    bool endsWith(const String& suffix) const {
+      return s.size() >= suffix.s.size() && s.compare(s.size() - suffix.s.size(), suffix.s.size(), suffix.s) == 0;
+    }
+    int indexOf(char c, unsigned int from = 0) const { return find(s.find(c, from)); }
+    int indexOf(const String& other, unsigned int from = 0) const { return find(s.find(other.s, from)); }
+    String substring(unsigned int from) const { return from < s.size() ? String(s.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const {
+      return from < to && from < s.size() ? String(s.substr(from, to - from)) : String();
+    }
+    void trim();
+    void toUpperCase();
+    void toLowerCase();
+    long toInt() const { return atol(s.c_str()); }
+    void getBytes(unsigned char* buffer, unsigned int size) const;
+    void toCharArray(char* buffer, unsigned int size) const { getBytes((unsigned char*)buffer, size); }
+
+  private:
+    typedef std::basic_string<char, std::char_traits<char>, MallocAllocator<char> > Chars;
+    Chars s;
+
+    String(const Chars& s) : s(s) {}
+    static Chars format(unsigned long value, unsigned char base);
+    static Chars format(long value, unsigned char base);
+    static Chars format(int value, unsigned char base) { return format((long)value, base); }
+    static Chars format(unsigned int value, unsigned char base) { return format((unsigned long)value, base); }
+    static Chars format(unsigned char value, unsigned char base) { return format((unsigned long)value, base); }
+    static int find(size_t position) { return position == Chars::npos ? -1 : (int)position; }
+};
+
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+    size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+
+    size_t print(const __FlashStringHelper* s) { return write(reinterpret_cast<const char*>(s)); }
+    size_t print(const String& s) { return write(s.c_str()); }
+    size_t print(const char* s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(int value, int base = DEC) { return print((long)value, base); }
+    size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+
+    size_t println() { return write("\r\n"); }
+    template <class T> size_t println(T value) { return print(value) + println(); }
+    template <class T> size_t println(T value, int format) { return print(value, format) + println(); }
+};
+
+
+class Stream : public Print {
+  public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual void flush() {}
+};
+
+
+/*
+ * Serial collects its output, tests read and clear it. Received chars are queued
+ * with receive().
+ */
+class HardwareSerial : public Stream {
+  public:
+    void begin(unsigned long baud) {}
+    operator bool() { return true; }
+    size_t write(uint8_t c);
+    using Print::write;
+    int available() { return input.size(); }
+    int read();
+    int peek() { return input.empty() ? -1 : (byte)input[0]; }
+
+    void receive(const char* s) { input += s; }     // host only
+    const char* output() { return out.c_str(); }     // host only
+    void clearOutput() { out.clear(); }               // host only
+
+  private:
+    std::string out;
+    std::string input;
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,44 @@
+/*
+ * Subset of ArduinoUnit on the host, the tests are written like the ones running
+ * on the Arduino: test(name) { assertEqual(...); } and loop() { Test::run(); }.
+ * The process exits with the number of failed tests.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <ArduinoUnit.h>
+
+Test* Test::first = NULL;
+
+
+Test::Test(const char* name, void (*function)(Test&))
+: name(name), function(function) {
+  Test** last = &first;
+  while (*last) last = &(*last)->next;
+  *last = this;
+}
+
+bool Test::check(bool ok, const char* file, int line, const char* expression) {
+  if (!ok) {
+    printf("Assertion failed: (%s), file %s, line %d.\n", expression, file, line);
+    failed = true;
+  }
+  return ok;
+}
+
+/*
+ * Run all tests in the order of their definition and exit.
+ */
+void Test::run() {
+  int passed = 0;
+  int failures = 0;
+  for (Test* test = first; test; test = test->next) {
+    test->function(*test);
+    printf("Test %s %s.\n", test->name, test->failed ? "failed" : "passed");
+    if (test->failed) failures++; else passed++;
+  }
+  printf("Test summary: %d passed, %d failed, out of %d test(s).\n", passed, failures, passed + failures);
+  exit(failures);
+}
@@ -0,0 +1,49 @@
+/*
+ * Subset of ArduinoUnit on the host, the tests are written like the ones running
+ * on the Arduino: test(name) { assertEqual(...); } and loop() { Test::run(); }.
+ * The process exits with the number of failed tests.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef ArduinoUnit_h
+#define ArduinoUnit_h
+
+#include <Arduino.h>
+
+
+class Test {
+  public:
+    Test(const char* name, void (*function)(Test&));
+    static void run();
+
+    bool check(bool ok, const char* file, int line, const char* expression);
+
+  private:
+    const char* name;
+    void (*function)(Test&);
+    bool failed = false;
+    Test* next = NULL;
+
+    static Test* first;
+};
+
+#define test(name) \
+  static void test_##name(Test& __test); \
+  static Test test_##name##_instance(#name, test_##name); \
+  static void test_##name(Test& __test)
+
+#define assertOp(a, op, b) \
+  do { if (!__test.check((a) op (b), __FILE__, __LINE__, #a " " #op " " #b)) return; } while (0)
+
+#define assertEqual(a, b)      assertOp(a, ==, b)
+#define assertNotEqual(a, b)   assertOp(a, !=, b)
+#define assertLess(a, b)       assertOp(a, <, b)
+#define assertMore(a, b)       assertOp(a, >, b)
+#define assertLessOrEqual(a, b)   assertOp(a, <=, b)
+#define assertMoreOrEqual(a, b)   assertOp(a, >=, b)
+#define assertTrue(a)          assertOp(a, ==, true)
+#define assertFalse(a)         assertOp(a, ==, false)
+
+#endif
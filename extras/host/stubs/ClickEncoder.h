@@ -0,0 +1,41 @@
+/*
+ * ClickEncoder library on the host, turns and button events are set by the test.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef __have__ClickEncoder_h__
+#define __have__ClickEncoder_h__
+
+#include <Arduino.h>
+
+
+class ClickEncoder {
+  public:
+    typedef enum Button_e {
+      Open = 0,
+      Closed,
+      Pressed,
+      Held,
+      Released,
+      Clicked,
+      DoubleClicked
+    } Button;
+
+    ClickEncoder(uint8_t A, uint8_t B, uint8_t BTN = -1, uint8_t stepsPerNotch = 1, bool active = LOW, bool pullup = HIGH) {}
+
+    void service(void) { services++; }
+    int16_t getValue(void) { int16_t value = delta; delta = 0; return value; }
+    Button getButton(void) { Button result = button; if (button != Held) button = Open; return result; }
+
+    void turn(int16_t steps) { delta += steps; }        // host only
+    void press(Button event) { button = event; }        // host only
+    uint32_t services = 0;                              // host only
+
+  private:
+    int16_t delta = 0;
+    Button button = Open;
+};
+
+#endif
@@ -0,0 +1,174 @@
+/*
+ * Heap of the AVR on the host. The programs linked with HEAP_FLAGS (see Makefile)
+ * allocate with malloc() and free() of avr-libc on a heap of HEAP_SIZE bytes: each
+ * chunk has a size header, the free list is sorted by address and adjacent chunks
+ * are merged, a free chunk at the top lowers the break. The calls and the use of
+ * the heap are counted in Heap.stats, the holes below the break are what fragments.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <Heap.h>
+
+HeapClass Heap;
+
+extern "C" {
+  void __real_free(void* memory);
+
+  void* __wrap_malloc(size_t size) {
+    return Heap.allocate(size);
+  }
+
+  void __wrap_free(void* memory) {
+    if (Heap.contains(memory)) {
+      Heap.release(memory);
+    } else {
+      __real_free(memory);   // allocated by the host libraries
+    }
+  }
+}
+
+
+/*
+ * A free chunk has the size and the next free chunk, an allocated one only the size.
+ */
+uint16_t HeapClass::get(uint16_t offset) {
+  return memory[offset] | (memory[offset + 1] << 8);
+}
+
+void HeapClass::set(uint16_t offset, uint16_t value) {
+  memory[offset] = lowByte(value);
+  memory[offset + 1] = highByte(value);
+}
+
+/*
+ * The exact or else the smallest free chunk that fits, split if the rest can be
+ * a chunk of its own (the upper part is returned). Without one the break is raised.
+ */
+void* HeapClass::allocate(size_t size) {
+  stats.mallocs++;
+  stats.bytes += size;
+  if (size < HEAP_HEADER) size = HEAP_HEADER;   // room for the next pointer when freed
+  if (size > HEAP_SIZE) {
+    stats.failures++;
+    return NULL;
+  }
+
+  uint16_t best = HEAP_NONE;
+  uint16_t bestPrevious = HEAP_NONE;
+  for (uint16_t previous = HEAP_NONE, chunk = freeList; chunk != HEAP_NONE; previous = chunk, chunk = get(chunk + HEAP_HEADER)) {
+    uint16_t chunkSize = get(chunk);
+    if (chunkSize >= size && (best == HEAP_NONE || chunkSize < get(best))) {
+      best = chunk;
+      bestPrevious = previous;
+      if (chunkSize == size) break;
+    }
+  }
+
+  uint16_t chunk;
+  if (best != HEAP_NONE && get(best) < size + 2 * HEAP_HEADER) {
+    chunk = best;
+    uint16_t next = get(best + HEAP_HEADER);
+    if (bestPrevious == HEAP_NONE) {
+      freeList = next;
+    } else {
+      set(bestPrevious + HEAP_HEADER, next);
+    }
+  } else if (best != HEAP_NONE) {
+    uint16_t rest = get(best) - size - HEAP_HEADER;
+    set(best, rest);
+    chunk = best + HEAP_HEADER + rest;
+    set(chunk, size);
+  } else if (brk + size + HEAP_HEADER <= HEAP_SIZE) {
+    chunk = brk;
+    brk += size + HEAP_HEADER;
+    if (brk > stats.peak) stats.peak = brk;
+    set(chunk, size);
+  } else {
+    stats.failures++;
+    return NULL;
+  }
+  stats.used += get(chunk) + HEAP_HEADER;
+  stats.maxHoles = max(stats.maxHoles, holes());
+  return &memory[chunk + HEAP_HEADER];
+}
+
+/*
+ * Insert the chunk into the free list and merge it with its neighbours,
+ * the topmost free chunk is given back to the break.
+ */
+void HeapClass::release(void* data) {
+  if (!data) return;
+  stats.frees++;
+  uint16_t chunk = (uint8_t*)data - memory - HEAP_HEADER;
+  stats.used -= get(chunk) + HEAP_HEADER;
+
+  uint16_t previous = HEAP_NONE;
+  uint16_t next = freeList;
+  while (next != HEAP_NONE && next < chunk) {
+    previous = next;
+    next = get(next + HEAP_HEADER);
+  }
+
+  if (next != HEAP_NONE && chunk + HEAP_HEADER + get(chunk) == next) {
+    set(chunk, get(chunk) + HEAP_HEADER + get(next));
+    next = get(next + HEAP_HEADER);
+  }
+  set(chunk + HEAP_HEADER, next);
+  if (previous == HEAP_NONE) {
+    freeList = chunk;
+  } else if (previous + HEAP_HEADER + get(previous) == chunk) {
+    set(previous, get(previous) + HEAP_HEADER + get(chunk));
+    set(previous + HEAP_HEADER, next);
+  } else {
+    set(previous + HEAP_HEADER, chunk);
+  }
+
+  uint16_t last = HEAP_NONE;
+  uint16_t beforeLast = HEAP_NONE;
+  for (uint16_t c = freeList; c != HEAP_NONE; c = get(c + HEAP_HEADER)) {
+    beforeLast = last;
+    last = c;
+  }
+  if (last != HEAP_NONE && last + HEAP_HEADER + get(last) == brk) {
+    brk = last;
+    if (beforeLast == HEAP_NONE) {
+      freeList = HEAP_NONE;
+    } else {
+      set(beforeLast + HEAP_HEADER, HEAP_NONE);
+    }
+  }
+  stats.maxHoles = max(stats.maxHoles, holes());
+}
+
+bool HeapClass::contains(const void* data) {
+  return data >= (const void*)memory && data < (const void*)&memory[HEAP_SIZE];
+}
+
+void HeapClass::reset() {
+  brk = 0;
+  freeList = HEAP_NONE;
+  stats = HeapStats();
+}
+
+uint16_t HeapClass::top() {
+  return brk;
+}
+
+uint16_t HeapClass::holes() {
+  uint16_t bytes = 0;
+  for (uint16_t chunk = freeList; chunk != HEAP_NONE; chunk = get(chunk + HEAP_HEADER)) {
+    bytes += get(chunk) + HEAP_HEADER;
+  }
+  return bytes;
+}
+
+uint16_t HeapClass::largestHole() {
+  uint16_t largest = 0;
+  for (uint16_t chunk = freeList; chunk != HEAP_NONE; chunk = get(chunk + HEAP_HEADER)) {
+    largest = max(largest, get(chunk));
+  }
+  return largest;
+}
@@ -0,0 +1,56 @@
+/*
+ * Heap of the AVR on the host. The programs linked with HEAP_FLAGS (see Makefile)
+ * allocate with malloc() and free() of avr-libc on a heap of HEAP_SIZE bytes: each
+ * chunk has a size header, the free list is sorted by address and adjacent chunks
+ * are merged, a free chunk at the top lowers the break. The calls and the use of
+ * the heap are counted in Heap.stats, the holes below the break are what fragments.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef Heap_h
+#define Heap_h
+
+#include <Arduino.h>
+
+#define HEAP_SIZE     2560    // all of the SRAM of the 32u4, an upper bound
+#define HEAP_HEADER   2       // size of a chunk
+#define HEAP_NONE     0xFFFF  // end of the free list
+
+
+struct HeapStats {
+  uint32_t mallocs;
+  uint32_t frees;
+  uint32_t failures;        // out of memory
+  uint32_t bytes;           // requested
+  uint16_t used;            // allocated chunks incl. headers
+  uint16_t peak;            // highest break
+  uint16_t maxHoles;        // most free bytes below the break
+};
+
+
+class HeapClass {
+  public:
+    void* allocate(size_t size);
+    void release(void* memory);
+    bool contains(const void* memory);
+
+    void reset();                     // empty heap, stats cleared
+    uint16_t top();                   // break, bytes from the start of the heap
+    uint16_t holes();                 // free bytes below the break
+    uint16_t largestHole();
+    HeapStats stats;
+
+  private:
+    uint8_t memory[HEAP_SIZE];
+    uint16_t brk = 0;
+    uint16_t freeList = HEAP_NONE;    // first free chunk
+
+    uint16_t get(uint16_t offset);
+    void set(uint16_t offset, uint16_t value);
+};
+
+extern HeapClass Heap;
+
+#endif
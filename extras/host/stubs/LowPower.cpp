@@ -0,0 +1,33 @@
+/*
+ * Low-Power and TimerOne libraries on the host. Idle advances the clock to the next
+ * timer interrupt (Timer1 or the 1 ms Timer0), power down by the sleep period.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <LowPower.h>
+#include <TimerOne.h>
+#include <SPI.h>
+
+LowPowerClass LowPower;
+TimerOne Timer1;
+SPIClass SPI;
+
+static const unsigned long SLEEP_MILLIS[] = { 15, 30, 60, 120, 250, 500, 1000, 2000, 4000, 8000 };
+
+
+void LowPowerClass::idle(period_t period, adc_t adc, timer4_t timer4, timer3_t timer3, timer1_t timer1,
+                         timer0_t timer0, spi_t spi, usart1_t usart1, twi_t twi, usb_t usb) {
+  unsigned long tick = Timer1.isr && Timer1.period ? Timer1.period : 1000;
+  unsigned long wait = tick - micros() % tick;
+  advanceMicros(wait);
+  idles++;
+  idleMicros += wait;
+  if (Timer1.isr) Timer1.isr();
+}
+
+void LowPowerClass::powerDown(period_t period, adc_t adc, bod_t bod) {
+  if (period < SLEEP_FOREVER) delay(SLEEP_MILLIS[period]);
+}
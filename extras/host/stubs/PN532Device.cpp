@@ -0,0 +1,227 @@
+/*
+ * Emulated PN532 nfc reader on the host, attached to Wire at 0x24 and driving its
+ * irq pin (low while a response is ready). It answers the commands used by the
+ * PN532 library with a ready byte, the ACK frame and the response frame, repeats
+ * the last response on a NACK and loses the first command after power down.
+ * Listing a target (InListPassiveTarget) waits for a card like the PN532 after reset.
+ * Cards are put into the field and removed by the test, their memory is read
+ * in blocks (4 byte uid, Mifare Classic) or pages (7 byte uid, Ultralight).
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <PN532Device.h>
+
+static const uint8_t ACK[] = { 0x00, 0x00, 0xFF, 0x00, 0xFF, 0x00 };
+static const uint8_t NACK[] = { 0x00, 0x00, 0xFF, 0xFF, 0x00, 0x00 };
+
+#define PN532_HOSTTOPN532   0xD4
+#define PN532_PN532TOHOST   0xD5
+
+
+PN532Device::PN532Device(uint8_t irqPin)
+: irqPin(irqPin) {
+  memset(&stats, 0, sizeof(stats));
+  Wire.attach(PN532_DEVICE_ADDRESS, this);
+  setPinSource(irqPin, this);
+}
+
+void PN532Device::present(const uint8_t* uid, uint8_t length, const std::vector<uint8_t>& memory) {
+  memcpy(this->uid, uid, min(length, sizeof(this->uid)));
+  uidLength = min(length, sizeof(this->uid));
+  this->memory = memory;
+}
+
+void PN532Device::remove() {
+  uidLength = 0;
+}
+
+/*
+ * Ultralight memory (NFC Forum type 2) holding the encoded NDEF message.
+ */
+std::vector<uint8_t> PN532Device::ultralight(const uint8_t* message, uint8_t length) {
+  std::vector<uint8_t> memory(16, 0);
+  memory[12] = 0xE1;    // capability container: NDEF, version 1.0, 144 bytes
+  memory[13] = 0x10;
+  memory[14] = 0x12;
+  memory.push_back(0x03);
+  memory.push_back(length);
+  memory.insert(memory.end(), message, message + length);
+  memory.push_back(0xFE);
+  if (memory.size() < 16 * 10) memory.resize(16 * 10, 0);
+  return memory;
+}
+
+/*
+ * Ultralight memory holding an NDEF message with a single uri record without prefix.
+ */
+std::vector<uint8_t> PN532Device::ultralightUri(const char* path) {
+  uint8_t length = strlen(path);
+  uint8_t record[] = { 0xD1, 0x01, (uint8_t)(length + 1), 'U', 0x00 };
+  std::vector<uint8_t> message(record, record + sizeof(record));
+  message.insert(message.end(), path, path + length);
+  return ultralight(message.data(), message.size());
+}
+
+/*
+ * Host frames: command, ACK (abort) or NACK (send the response again).
+ */
+void PN532Device::receive(uint8_t address, const uint8_t* data, uint8_t length) {
+  if (length == sizeof(ACK) && memcmp(data, ACK, length) == 0) {
+    stats.aborts++;
+    ackReady = responseReady = polling = listing = false;
+    return;
+  }
+  if (length == sizeof(NACK) && memcmp(data, NACK, length) == 0) {
+    stats.nacks++;
+    responseReady = !response.empty();
+    return;
+  }
+  if (poweredDown) {
+    poweredDown = false;
+    stats.lost++;
+    return;
+  }
+  // 00 00 FF LEN LCS D4 CMD ... DCS 00
+  if (length < 8 || data[2] != 0xFF || (uint8_t)(data[3] + data[4]) != 0 || data[5] != PN532_HOSTTOPN532) return;
+  stats.commands++;
+  lastCommand = data[6];
+  ackReady = true;
+  responseReady = polling = listing = false;
+  execute(data + 6, data[3] - 1);
+}
+
+/*
+ * Status byte (ready) followed by the ACK or response frame, a frame is kept
+ * when only the status is read.
+ */
+uint8_t PN532Device::request(uint8_t address, uint8_t* data, uint8_t length) {
+  update();
+  memset(data, 0, length);
+  if (ackReady) {
+    data[0] = 0x01;
+    if (length == 1) return length;
+    memcpy(data + 1, ACK, min(length - 1, (int)sizeof(ACK)));
+    ackReady = false;
+    stats.acks++;
+  } else if (responseReady) {
+    data[0] = 0x01;
+    if (length == 1) return length;
+    memcpy(data + 1, response.data(), min(length - 1, (int)response.size()));
+    responseReady = false;
+    stats.responses++;
+  }
+  return length;
+}
+
+int PN532Device::readPin(uint8_t pin) {
+  update();
+  return ackReady || responseReady ? LOW : HIGH;
+}
+
+void PN532Device::execute(const uint8_t* data, uint8_t length) {
+  uint8_t command = data[0];
+  switch (command) {
+    case 0x02: {   // GetFirmwareVersion: PN532 v1.6
+      const uint8_t version[] = { 0x32, 0x01, 0x06, 0x07 };
+      respond(command, version, sizeof(version));
+      break;
+    }
+    case 0x14:     // SAMConfiguration
+    case 0x32:     // RFConfiguration
+      respond(command, NULL, 0);
+      break;
+    case 0x16: {   // PowerDown
+      const uint8_t status = 0x00;
+      respond(command, &status, 1);
+      poweredDown = true;
+      break;
+    }
+    case 0x4A:     // InListPassiveTarget: retries until a card is found (default after reset)
+      listing = true;
+      break;
+    case 0x60:     // InAutoPoll: PollNr Period Type
+      polling = true;
+      pollsLeft = data[1];
+      pollPeriod = PN532_DEVICE_POLL_MILLIS * max(1, data[2]);
+      nextPoll = millis();
+      break;
+    case 0x40: {   // InDataExchange: Tg Cmd Addr ...
+      uint8_t result[17] = { 0x01 };   // timeout, no card
+      uint8_t size = 1;
+      if (uidLength > 0 && data[2] == 0x30) {   // read 16 bytes
+        unsigned long start = data[3] * (uidLength == 4 ? 16UL : 4UL);
+        result[0] = 0x00;
+        for (uint8_t i = 0; i < 16; i++) {
+          result[1 + i] = start + i < memory.size() ? memory[start + i] : 0;
+        }
+        size = 17;
+      } else if (uidLength > 0) {
+        result[0] = 0x00;      // authenticated, written
+      }
+      respond(command, result, size);
+      break;
+    }
+    case 0x52: {   // InRelease
+      const uint8_t status = 0x00;
+      respond(command, &status, 1);
+      break;
+    }
+    default:
+      respond(command, NULL, 0);
+  }
+}
+
+/*
+ * 00 00 FF LEN LCS D5 CMD+1 ... DCS 00, ready after the ACK was read.
+ */
+void PN532Device::respond(uint8_t command, const uint8_t* data, uint8_t length) {
+  response.clear();
+  uint8_t frameLength = length + 2;
+  response.push_back(0x00);
+  response.push_back(0x00);
+  response.push_back(0xFF);
+  response.push_back(frameLength);
+  response.push_back(~frameLength + 1);
+  response.push_back(PN532_PN532TOHOST);
+  response.push_back(command + 1);
+  uint8_t sum = PN532_PN532TOHOST + command + 1;
+  for (uint8_t i = 0; i < length; i++) {
+    response.push_back(data[i]);
+    sum += data[i];
+  }
+  response.push_back(~sum + 1);
+  response.push_back(0x00);
+  responseReady = true;
+}
+
+/*
+ * The response of a command is ready once its ACK was read. A listed target responds
+ * when a card is in the field, autonomous polling when a poll found a card or when
+ * all polls are done.
+ */
+void PN532Device::update() {
+  if (ackReady) return;
+  if (listing && uidLength > 0) {
+    uint8_t target[] = { 1, 1, 0x00, 0x44, 0x00, uidLength, 0, 0, 0, 0, 0, 0, 0 };
+    memcpy(target + 6, uid, uidLength);
+    respond(0x4A, target, 6 + uidLength);
+    listing = false;
+  }
+  while (polling && millis() >= nextPoll) {
+    if (uidLength > 0) {
+      uint8_t target[] = { 1, 0x10, (uint8_t)(5 + uidLength), 1, 0x00, 0x44, 0x00, uidLength, 0, 0, 0, 0, 0, 0, 0 };
+      memcpy(target + 8, uid, uidLength);
+      respond(0x60, target, 8 + uidLength);
+      stats.polls++;
+      polling = false;
+    } else if (pollsLeft != 0xFF && --pollsLeft == 0) {
+      const uint8_t none = 0;
+      respond(0x60, &none, 1);
+      polling = false;
+    }
+    nextPoll += pollPeriod;
+  }
+}
@@ -0,0 +1,73 @@
+/*
+ * Emulated PN532 nfc reader on the host, attached to Wire at 0x24 and driving its
+ * irq pin (low while a response is ready). It answers the commands used by the
+ * PN532 library with a ready byte, the ACK frame and the response frame, repeats
+ * the last response on a NACK and loses the first command after power down.
+ * Listing a target (InListPassiveTarget) waits for a card like the PN532 after reset.
+ * Cards are put into the field and removed by the test, their memory is read
+ * in blocks (4 byte uid, Mifare Classic) or pages (7 byte uid, Ultralight).
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef PN532Device_h
+#define PN532Device_h
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <vector>
+
+#define PN532_DEVICE_ADDRESS       0x24
+#define PN532_DEVICE_POLL_MILLIS    150    // autonomous polling period unit
+
+
+struct PN532Stats {
+  uint32_t commands;
+  uint32_t acks;          // ACK frames read
+  uint32_t responses;     // response frames read
+  uint32_t nacks;         // responses requested again
+  uint32_t aborts;
+  uint32_t lost;          // commands lost while waking up
+  uint32_t polls;         // autonomous polls found a card
+};
+
+
+class PN532Device : public WireDevice, public PinSource {
+  public:
+    PN532Device(uint8_t irqPin);
+
+    void present(const uint8_t* uid, uint8_t length, const std::vector<uint8_t>& memory = std::vector<uint8_t>());
+    void remove();
+    static std::vector<uint8_t> ultralight(const uint8_t* message, uint8_t length);  // encoded NDEF message
+    static std::vector<uint8_t> ultralightUri(const char* path);  // NDEF message with an uri record
+
+    void receive(uint8_t address, const uint8_t* data, uint8_t length);
+    uint8_t request(uint8_t address, uint8_t* data, uint8_t length);
+    int readPin(uint8_t pin);
+
+    PN532Stats stats;
+    uint8_t lastCommand = 0;
+    bool poweredDown = false;
+
+  private:
+    uint8_t irqPin;
+    uint8_t uid[7];
+    uint8_t uidLength = 0;   // 0 = no card in the field
+    std::vector<uint8_t> memory;
+
+    std::vector<uint8_t> response;   // frame of the last response
+    bool ackReady = false;
+    bool responseReady = false;
+    bool listing = false;            // InListPassiveTarget waiting for a card
+    bool polling = false;
+    uint8_t pollsLeft = 0;           // 0xFF = endless
+    unsigned long nextPoll = 0;
+    unsigned long pollPeriod = 0;
+
+    void execute(const uint8_t* data, uint8_t length);
+    void respond(uint8_t command, const uint8_t* data, uint8_t length);
+    void update();
+};
+
+#endif
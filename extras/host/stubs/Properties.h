@@ -0,0 +1,51 @@
+/*
+ * Properties library on the host, reads 'key=value' lines of a file.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef Properties_h
+#define Properties_h
+
+#include <Arduino.h>
+#include <SD.h>
+
+
+class Properties {
+  public:
+    Properties(File file) : file(file) {}
+
+    /*
+     * Value of the first line with the key, empty if not found. Comment lines start with '#' or '//'.
+     */
+    String readString(String key) {
+      if (!file) return String();
+      file.seek(0);
+      String line;
+      while (file.available()) {
+        char c = file.read();
+        if (c != '\n' && c != '\r') {
+          line += c;
+          if (file.available()) continue;
+        }
+        int separator = line.indexOf('=');
+        if (!line.startsWith("#") && !line.startsWith("//") && separator > 0) {
+          String name = line.substring(0, separator);
+          name.trim();
+          if (name == key) {
+            String value = line.substring(separator + 1);
+            value.trim();
+            return value;
+          }
+        }
+        line = String();
+      }
+      return String();
+    }
+
+  private:
+    File file;
+};
+
+#endif
@@ -0,0 +1,313 @@
+/*
+ * SD library on the host, the card is a directory (see SDClass::mount()).
+ * Copies of a File share the open file like on the Arduino. The card operations
+ * are counted in SD.stats to compare the access patterns of the classes. Like
+ * SdFat a single block is cached, each other block read or written (and each
+ * open for its directory entry) advances the clock by the time of its transfer.
+ * Reading an open directory returns its entries in the FAT layout (dir_t).
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <SD.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+SDClass SD;
+
+
+struct FileHandle {
+  std::string path;
+  std::string name;
+  FILE* file = NULL;
+  DIR* dir = NULL;
+  uint8_t mode = 0;
+  uint32_t position = 0;
+
+  ~FileHandle() { close(); }
+
+  void close() {
+    if (file) fclose(file);
+    if (dir) closedir(dir);
+    file = NULL;
+    dir = NULL;
+  }
+
+  bool isOpen() { return file || dir; }
+
+  uint32_t size() {
+    struct stat info;
+    if (file) fflush(file);
+    return stat(path.c_str(), &info) == 0 ? info.st_size : 0;
+  }
+
+  /*
+   * The entries of the directory like stored by FAT, terminated by a free entry.
+   */
+  std::vector<dir_t> entries() {
+    std::vector<dir_t> result;
+    DIR* listing = opendir(path.c_str());
+    struct dirent* entry;
+    while (listing && (entry = readdir(listing)) != NULL) {
+      if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+      dir_t fat;
+      memset(&fat, 0, sizeof(fat));
+      memset(fat.name, ' ', sizeof(fat.name));
+      const char* dot = strrchr(entry->d_name, '.');
+      size_t length = dot ? dot - entry->d_name : strlen(entry->d_name);
+      for (size_t i = 0; i < length && i < 8; i++) fat.name[i] = toupper(entry->d_name[i]);
+      for (size_t i = 0; dot && dot[i + 1] && i < 3; i++) fat.name[8 + i] = toupper(dot[i + 1]);
+      struct stat info;
+      if (stat((path + "/" + entry->d_name).c_str(), &info) == 0) {
+        fat.attributes = S_ISDIR(info.st_mode) ? DIR_ATT_DIRECTORY : 0;
+        fat.fileSize = S_ISDIR(info.st_mode) ? 0 : info.st_size;
+      }
+      result.push_back(fat);
+    }
+    if (listing) closedir(listing);
+    dir_t free;
+    memset(&free, 0, sizeof(free));
+    result.push_back(free);
+    return result;
+  }
+
+  void transfer(uint32_t start, size_t length) {
+    if (length == 0) return;
+    for (uint32_t block = start / SD_BLOCK_SIZE; block <= (start + length - 1) / SD_BLOCK_SIZE; block++) {
+      SD.transfer(path, block);
+    }
+  }
+};
+
+
+size_t File::write(const uint8_t* buffer, size_t size) {
+  if (!handle || !handle->file || !(handle->mode & O_WRITE)) return 0;
+  if (handle->mode & O_APPEND) handle->position = handle->size();
+  fseek(handle->file, handle->position, SEEK_SET);
+  size_t n = fwrite(buffer, 1, size, handle->file);
+  handle->transfer(handle->position, n);
+  handle->position += n;
+  SD.stats.writes++;
+  SD.stats.bytesWritten += n;
+  return n;
+}
+
+int File::read() {
+  byte b;
+  return read(&b, 1) == 1 ? b : -1;
+}
+
+int File::read(void* buffer, uint16_t size) {
+  if (handle && handle->dir) {
+    std::vector<dir_t> entries = handle->entries();
+    uint32_t length = entries.size() * sizeof(dir_t);
+    uint16_t n = handle->position < length ? min((uint32_t)size, length - handle->position) : 0;
+    memcpy(buffer, (const byte*)entries.data() + handle->position, n);
+    handle->transfer(handle->position, n);
+    handle->position += n;
+    SD.stats.reads++;
+    SD.stats.bytesRead += n;
+    return n;
+  }
+  if (!handle || !handle->file) return -1;
+  fseek(handle->file, handle->position, SEEK_SET);
+  size_t n = fread(buffer, 1, size, handle->file);
+  handle->transfer(handle->position, n);
+  handle->position += n;
+  SD.stats.reads++;
+  SD.stats.bytesRead += n;
+  return n;
+}
+
+int File::peek() {
+  if (!handle || !handle->file) return -1;
+  fseek(handle->file, handle->position, SEEK_SET);
+  return fgetc(handle->file);
+}
+
+int File::available() {
+  if (!handle || !handle->file) return 0;
+  uint32_t size = handle->size();
+  return size > handle->position ? size - handle->position : 0;
+}
+
+void File::flush() {
+  if (handle && handle->file) fflush(handle->file);
+}
+
+bool File::seek(uint32_t position) {
+  if (!handle || !handle->file || position > handle->size()) return false;
+  handle->position = position;
+  SD.stats.seeks++;
+  return true;
+}
+
+uint32_t File::position() {
+  return handle ? handle->position : 0;
+}
+
+uint32_t File::size() {
+  return handle && handle->file ? handle->size() : 0;
+}
+
+/*
+ * Close the file of all copies (the other copies are invalid afterwards).
+ */
+void File::close() {
+  if (handle) handle->close();
+  handle.reset();
+}
+
+File::operator bool() {
+  return handle && handle->isOpen();
+}
+
+char* File::name() {
+  return handle ? (char*)handle->name.c_str() : (char*)"";
+}
+
+bool File::isDirectory() {
+  return handle && handle->dir;
+}
+
+/*
+ * Next entry of the directory in the order of the file system (unsorted like FAT).
+ */
+File File::openNextFile(uint8_t mode) {
+  if (!handle || !handle->dir) return File();
+  struct dirent* entry;
+  while ((entry = readdir(handle->dir)) != NULL) {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+    std::string path = handle->path + "/" + entry->d_name;
+    auto next = std::make_shared<FileHandle>();
+    next->path = path;
+    next->name = entry->d_name;
+    next->mode = mode;
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+      next->dir = opendir(path.c_str());
+    } else {
+      next->file = fopen(path.c_str(), (mode & O_WRITE) ? "r+b" : "rb");
+    }
+    SD.stats.opens++;
+    SD.transfer(handle->path, 0);
+    return File(next);
+  }
+  return File();
+}
+
+void File::rewindDirectory() {
+  if (handle && handle->dir) rewinddir(handle->dir);
+}
+
+
+bool SDClass::begin(uint8_t csPin) {
+  struct stat info;
+  return stat(root.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+std::string SDClass::hostPath(const char* path) {
+  while (*path == '/') path++;
+  std::string result = root + "/" + path;
+  while (result.size() > root.size() + 1 && result[result.size() - 1] == '/') {
+    result.erase(result.size() - 1);
+  }
+  return result;
+}
+
+File SDClass::open(const char* path, uint8_t mode) {
+  auto handle = std::make_shared<FileHandle>();
+  handle->path = hostPath(path);
+  const char* slash = strrchr(handle->path.c_str(), '/');
+  handle->name = slash ? slash + 1 : handle->path;
+  handle->mode = mode;
+
+  struct stat info;
+  bool found = stat(handle->path.c_str(), &info) == 0;
+  if (found && S_ISDIR(info.st_mode)) {
+    handle->dir = opendir(handle->path.c_str());
+  } else if (!(mode & O_WRITE)) {
+    handle->file = found ? fopen(handle->path.c_str(), "rb") : NULL;
+  } else if (found && !(mode & O_TRUNC)) {
+    handle->file = fopen(handle->path.c_str(), "r+b");
+  } else if (found || (mode & O_CREAT)) {
+    handle->file = fopen(handle->path.c_str(), "w+b");
+  }
+  if (!handle->isOpen()) return File();
+  if (mode & O_APPEND) handle->position = handle->size();
+  stats.opens++;
+  transfer("/", 0);   // directory entry
+  return File(handle);
+}
+
+/*
+ * Count the block and advance the clock unless it is the cached block.
+ */
+void SDClass::transfer(const std::string& path, uint32_t block) {
+  if (path == cachedPath && block == cachedBlock) return;
+  cachedPath = path;
+  cachedBlock = block;
+  stats.blocks++;
+  advanceMicros(SD_BLOCK_MICROS);
+}
+
+bool SDClass::exists(const char* path) {
+  struct stat info;
+  return stat(hostPath(path).c_str(), &info) == 0;
+}
+
+bool SDClass::remove(const char* path) {
+  return unlink(hostPath(path).c_str()) == 0;
+}
+
+/*
+ * Create the directory including its parents.
+ */
+bool SDClass::mkdir(const char* path) {
+  std::string full = hostPath(path);
+  for (size_t i = root.size() + 1; i <= full.size(); i++) {
+    if (i == full.size() || full[i] == '/') {
+      ::mkdir(full.substr(0, i).c_str(), 0755);
+    }
+  }
+  return exists(path);
+}
+
+bool SDClass::rmdir(const char* path) {
+  return ::rmdir(hostPath(path).c_str()) == 0;
+}
+
+static void removeAll(const std::string& path) {
+  DIR* dir = opendir(path.c_str());
+  if (!dir) {
+    unlink(path.c_str());
+    return;
+  }
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != NULL) {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+    removeAll(path + "/" + entry->d_name);
+  }
+  closedir(dir);
+  ::rmdir(path.c_str());
+}
+
+/*
+ * Use the (emptied) directory as card, created with its parents.
+ */
+void SDClass::mount(const char* directory) {
+  removeAll(directory);
+  std::string path = directory;
+  for (size_t i = 1; i <= path.size(); i++) {
+    if (i == path.size() || path[i] == '/') {
+      ::mkdir(path.substr(0, i).c_str(), 0755);
+    }
+  }
+  root = path;
+  stats = SdStats();
+  cachedPath.clear();
+}
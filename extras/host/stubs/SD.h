@@ -0,0 +1,124 @@
+/*
+ * SD library on the host, the card is a directory (see SDClass::mount()).
+ * Copies of a File share the open file like on the Arduino. The card operations
+ * are counted in SD.stats to compare the access patterns of the classes. Like
+ * SdFat a single block is cached, each other block read or written (and each
+ * open for its directory entry) advances the clock by the time of its transfer.
+ * Reading an open directory returns its entries in the FAT layout (dir_t).
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef SD_h
+#define SD_h
+
+#include <Arduino.h>
+#include <memory>
+
+// Open flags of SdFat
+#define O_READ     0x01
+#define O_RDONLY   O_READ
+#define O_WRITE    0x02
+#define O_WRONLY   O_WRITE
+#define O_RDWR     (O_READ | O_WRITE)
+#define O_APPEND   0x04
+#define O_CREAT    0x10
+#define O_TRUNC    0x40
+
+#define FILE_READ    O_READ
+#define FILE_WRITE   (O_READ | O_WRITE | O_CREAT | O_APPEND)
+
+#define SD_BLOCK_SIZE     512
+#define SD_BLOCK_MICROS  1200    // command and 512 bytes at 4 MHz SPI
+
+// Directory entry of FAT (SdFatStructs.h)
+#define DIR_NAME_FREE       0x00
+#define DIR_NAME_DELETED    0xE5
+#define DIR_ATT_VOLUME_ID   0x08
+#define DIR_ATT_DIRECTORY   0x10
+#define DIR_ATT_FILE_TYPE_MASK  (DIR_ATT_VOLUME_ID | DIR_ATT_DIRECTORY)
+#define DIR_IS_FILE(dir)    (((dir)->attributes & DIR_ATT_FILE_TYPE_MASK) == 0)
+
+struct dir_t {
+  uint8_t name[11];         // 8.3, blank padded
+  uint8_t attributes;
+  uint8_t reservedNT;
+  uint8_t creationTimeTenths;
+  uint16_t creationTime;
+  uint16_t creationDate;
+  uint16_t lastAccessDate;
+  uint16_t firstClusterHigh;
+  uint16_t lastWriteTime;
+  uint16_t lastWriteDate;
+  uint16_t firstClusterLow;
+  uint32_t fileSize;
+} __attribute__((packed));
+
+
+struct SdStats {
+  uint32_t opens;
+  uint32_t reads;           // read calls
+  uint32_t bytesRead;
+  uint32_t writes;          // write calls
+  uint32_t bytesWritten;
+  uint32_t seeks;
+  uint32_t blocks;          // blocks transferred
+};
+
+struct FileHandle;
+
+
+class File : public Stream {
+  public:
+    File() {}
+    File(std::shared_ptr<FileHandle> handle) : handle(handle) {}
+
+    size_t write(uint8_t b) { return write(&b, 1); }
+    size_t write(const uint8_t* buffer, size_t size);
+    using Print::write;
+    int read();
+    int read(void* buffer, uint16_t size);
+    int peek();
+    int available();
+    void flush();
+    bool seek(uint32_t position);
+    uint32_t position();
+    uint32_t size();
+    void close();
+    operator bool();
+
+    char* name();
+    bool isDirectory();
+    File openNextFile(uint8_t mode = O_READ);
+    void rewindDirectory();
+
+  private:
+    std::shared_ptr<FileHandle> handle;
+};
+
+
+class SDClass {
+  public:
+    bool begin(uint8_t csPin = 0);
+    File open(const char* path, uint8_t mode = FILE_READ);
+    File open(const String& path, uint8_t mode = FILE_READ) { return open(path.c_str(), mode); }
+    bool exists(const char* path);
+    bool remove(const char* path);
+    bool mkdir(const char* path);
+    bool rmdir(const char* path);
+
+    void mount(const char* directory);    // host only, empty card in the directory
+    std::string hostPath(const char* path);  // host only
+    SdStats stats;                        // host only
+    void transfer(const std::string& path, uint32_t block);   // host only
+
+  private:
+    std::string root = ".";
+    std::string cachedPath;
+    uint32_t cachedBlock = 0;
+};
+
+extern SDClass SD;
+
+#endif
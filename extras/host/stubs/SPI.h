@@ -0,0 +1,23 @@
+/*
+ * SPI library on the host (the card and decoder stubs do not use it).
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef _SPI_H_INCLUDED
+#define _SPI_H_INCLUDED
+
+#include <Arduino.h>
+
+
+class SPIClass {
+  public:
+    static void begin() {}
+    static void usingInterrupt(uint8_t interruptNumber) {}
+    static uint8_t transfer(uint8_t data) { return 0; }
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,28 @@
+/*
+ * TimerOne library on the host, the interrupt is called by LowPower.idle() for each
+ * period passed while idle.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef TimerOne_h_
+#define TimerOne_h_
+
+#include <Arduino.h>
+
+
+class TimerOne {
+  public:
+    void initialize(unsigned long microseconds = 1000000) { period = microseconds; }
+    void attachInterrupt(void (*isr)()) { this->isr = isr; }
+    void detachInterrupt() { isr = NULL; }
+    void setPeriod(unsigned long microseconds) { period = microseconds; }
+
+    void (*isr)() = NULL;     // host only
+    unsigned long period = 0; // host only
+};
+
+extern TimerOne Timer1;
+
+#endif
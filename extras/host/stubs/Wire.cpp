@@ -0,0 +1,55 @@
+/*
+ * Wire library on the host. Transmissions are passed to the device attached at
+ * the address (if any) and counted in Wire.stats like the bytes on the bus.
+ * Each byte advances the clock by its time on the bus.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <Wire.h>
+
+TwoWire Wire;
+
+
+void TwoWire::attach(uint8_t address, WireDevice* device) {
+  devices[address & 0x7F] = device;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  txAddress = address & 0x7F;
+  txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if (txLength >= BUFFER_LENGTH) return 0;
+  txBuffer[txLength++] = data;
+  return 1;
+}
+
+/*
+ * Returns 0 on success, 2 when no device acknowledged the address (like the AVR).
+ */
+uint8_t TwoWire::endTransmission(uint8_t sendStop) {
+  stats.transmissions++;
+  stats.bytesWritten += 1 + txLength;
+  stats.micros += WIRE_BYTE_MICROS * (1 + txLength);
+  advanceMicros(WIRE_BYTE_MICROS * (1 + txLength));
+  WireDevice* device = devices[txAddress];
+  if (!device) return 2;
+  device->receive(txAddress, txBuffer, txLength);
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop) {
+  WireDevice* device = devices[address & 0x7F];
+  if (quantity > BUFFER_LENGTH) quantity = BUFFER_LENGTH;
+  rxIndex = 0;
+  rxLength = device ? device->request(address & 0x7F, rxBuffer, quantity) : 0;
+  stats.requests++;
+  stats.bytesRead += 1 + rxLength;
+  stats.micros += WIRE_BYTE_MICROS * (1 + quantity);
+  advanceMicros(WIRE_BYTE_MICROS * (1 + quantity));
+  return rxLength;
+}
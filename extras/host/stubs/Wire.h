@@ -0,0 +1,67 @@
+/*
+ * Wire library on the host. Transmissions are passed to the device attached at
+ * the address (if any) and counted in Wire.stats like the bytes on the bus.
+ * Each byte advances the clock by its time on the bus.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef TwoWire_h
+#define TwoWire_h
+
+#include <Arduino.h>
+
+#define BUFFER_LENGTH   32
+#define WIRE_BYTE_MICROS   90    // 9 bits at 100 kHz
+
+
+struct WireStats {
+  uint32_t transmissions;
+  uint32_t requests;
+  uint32_t bytesWritten;     // incl. address byte
+  uint32_t bytesRead;        // incl. address byte
+  uint32_t micros;           // time on the bus
+};
+
+
+/*
+ * Device on the bus, implemented by the tests.
+ */
+class WireDevice {
+  public:
+    virtual ~WireDevice() {}
+    virtual void receive(uint8_t address, const uint8_t* data, uint8_t length) = 0;
+    virtual uint8_t request(uint8_t address, uint8_t* data, uint8_t length) = 0;
+};
+
+
+class TwoWire : public Stream {
+  public:
+    void begin() {}
+    void setClock(uint32_t clock) {}
+    void beginTransmission(uint8_t address);
+    uint8_t endTransmission(uint8_t sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop = true);
+    size_t write(uint8_t data);
+    using Print::write;
+    int available() { return rxLength - rxIndex; }
+    int read() { return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1; }
+    int peek() { return rxIndex < rxLength ? rxBuffer[rxIndex] : -1; }
+
+    void attach(uint8_t address, WireDevice* device);   // host only
+    WireStats stats;                                     // host only
+
+  private:
+    WireDevice* devices[128];
+    uint8_t txAddress = 0;
+    uint8_t txBuffer[BUFFER_LENGTH];
+    uint8_t txLength = 0;
+    uint8_t rxBuffer[BUFFER_LENGTH];
+    uint8_t rxLength = 0;
+    uint8_t rxIndex = 0;
+};
+
+extern TwoWire Wire;
+
+#endif
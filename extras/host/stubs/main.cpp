@@ -0,0 +1,20 @@
+/*
+ * Entry point of the host programs, runs the sketch functions like the Arduino core.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <Arduino.h>
+
+void setup();
+void loop();
+
+
+int main() {
+  setup();
+  while (true) {
+    loop();
+  }
+}
@@ -0,0 +1,95 @@
+/*
+ * Host tests of the bus trace of the trellis, built with BUS_TRACE (see Makefile).
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <ArduinoUnit.h>
+#include <Adafruit_Trellis.h>
+#include "Matrix.h"
+#include "BusTrace.h"
+
+#ifndef BUS_TRACE
+#error "BusTraceTest is built with BUS_TRACE"
+#endif
+
+HT16K33 trellis(TRELLIS_ADDRESS);
+Matrix matrix;
+
+struct Traced {
+  unsigned int transactions;
+  unsigned int bytes;
+};
+
+/*
+ * Print the trace and parse the line of the trellis.
+ */
+Traced printTrace() {
+  Serial.clearOutput();
+  busTrace.print();
+  Traced traced = { 0, 0 };
+  const char* line = strstr(Serial.output(), "Bus trellis: ");
+  if (line) sscanf(line, "Bus trellis: %u transactions, %u bytes", &traced.transactions, &traced.bytes);
+  return traced;
+}
+
+/*
+ * Bytes on the bus since the given stats without the address byte of each transaction.
+ */
+unsigned int dataBytes(const WireStats& before) {
+  return Wire.stats.bytesWritten + Wire.stats.bytesRead - before.bytesWritten - before.bytesRead
+      - (Wire.stats.transmissions + Wire.stats.requests - before.transmissions - before.requests);
+}
+
+void setup() {
+  Serial.begin(9600);
+  trellis.connectInterrupt(TRELLIS_INT_PIN);
+}
+
+test(initializeTraced)
+{
+  busTrace.clear();
+  WireStats before = Wire.stats;
+  matrix.initialize();
+  Traced traced = printTrace();
+  assertMore(traced.transactions, 0U);
+  assertEqual(dataBytes(before), traced.bytes);
+}
+
+test(flushTraced)
+{
+  matrix.blink(2, true);
+  matrix.flush();
+  busTrace.clear();
+  WireStats before = Wire.stats;
+  matrix.blink(5, false);    // another led and blink rate
+  matrix.flush();
+  Traced traced = printTrace();
+  assertEqual(2U, traced.transactions);
+  assertEqual(dataBytes(before), traced.bytes);
+}
+
+test(keysTraced)
+{
+  busTrace.clear();
+  WireStats before = Wire.stats;
+  trellis.press(3);
+  assertEqual(3, matrix.getPressedKey(millis()));
+  Traced traced = printTrace();
+  assertEqual(1U, traced.transactions);
+  assertEqual(dataBytes(before), traced.bytes);
+  trellis.release(3);
+}
+
+test(printClears)
+{
+  busTrace.record(BUS_TRELLIS, 2, micros());
+  assertEqual(1U, printTrace().transactions);
+  assertEqual(0U, printTrace().transactions);
+}
+
+void loop() {
+  Test::run();
+}
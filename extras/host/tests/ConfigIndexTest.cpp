@@ -0,0 +1,275 @@
+/*
+ * Host tests of ConfigIndex, the SD card is the directory build/sd/ConfigIndexTest.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <ArduinoUnit.h>
+#include "ConfigIndex.h"
+
+const char BUTTONS[] =
+  "// Assign each of the button a folder\n"
+  "0=GLOBI/SPORT\n"
+  "1=GLOBI/GOLD  \r\n"
+  "\n"
+  "10 = BOND/PFOSCHTE\n"
+  "11=\n"
+  "idle.show=running\n"
+  "15=PINGU";
+
+void writeFile(const char* name, const char* text) {
+  SD.remove(name);
+  File file = SD.open(name, FILE_WRITE);
+  file.write(text);
+  file.close();
+}
+
+void appendFile(const char* name, const char* text) {
+  File file = SD.open(name, FILE_WRITE);
+  file.write(text);
+  file.close();
+}
+
+void setup() {
+  Serial.begin(9600);
+  SD.mount("sd/ConfigIndexTest");
+}
+
+test(lookupIndexed)
+{
+  writeFile("buttons.cfg", BUTTONS);
+  ConfigIndex cfg = ConfigIndex("buttons.cfg", "buttons.idx");
+  cfg.initialize();
+  assertTrue(SD.exists("buttons.idx"));
+
+  char value[CONFIG_VALUE_LENGTH];
+  long offset;
+  assertTrue(cfg.lookup("0", value, sizeof(value), &offset));
+  assertEqual(0, strcmp("GLOBI/SPORT", value));
+  assertEqual((long)strchr(BUTTONS, 'G') - (long)BUTTONS, offset);
+  assertTrue(cfg.lookup("1", value, sizeof(value)));
+  assertEqual(0, strcmp("GLOBI/GOLD", value));    // trailing blanks removed
+  assertTrue(cfg.lookup("10", value, sizeof(value)));
+  assertEqual(0, strcmp("BOND/PFOSCHTE", value));    // blanks after = skipped
+  assertTrue(cfg.lookup("15", value, sizeof(value)));
+  assertEqual(0, strcmp("PINGU", value));    // last line without newline
+}
+
+test(lookupMissing)
+{
+  writeFile("buttons.cfg", BUTTONS);
+  ConfigIndex cfg = ConfigIndex("buttons.cfg", "buttons.idx");
+  cfg.initialize();
+
+  char value[CONFIG_VALUE_LENGTH] = "garbage";
+  long offset = 0;
+  assertFalse(cfg.lookup("2", value, sizeof(value), &offset));
+  assertEqual(0, strcmp("", value));
+  assertEqual(-1L, offset);
+  assertFalse(cfg.lookup("11", value, sizeof(value), &offset));    // empty value
+  assertEqual(0, strcmp("", value));
+}
+
+/*
+ * An empty value (e.g. written for an unknown tag) does not hide a later one.
+ */
+test(lookupDuplicateKey)
+{
+  writeFile("nfc.cfg", "04DEAD01=\n04A1B2C3=ALBUM\n04DEAD01=GLOBI/ZOO\n04DEAD01=GLOBI/GOLD\n");
+  ConfigIndex cfg = ConfigIndex("nfc.cfg", "nfc.idx");
+  cfg.initialize();
+
+  char value[CONFIG_VALUE_LENGTH];
+  long offset;
+  assertTrue(cfg.lookup("04DEAD01", value, sizeof(value), &offset));
+  assertEqual(0, strcmp("GLOBI/ZOO", value));
+  assertEqual(34L, offset);
+  assertTrue(cfg.lookup("04A1B2C3", value, sizeof(value)));
+  assertEqual(0, strcmp("ALBUM", value));
+}
+
+test(lookupNotHexScans)
+{
+  writeFile("buttons.cfg", BUTTONS);
+  ConfigIndex cfg = ConfigIndex("buttons.cfg", "buttons.idx");
+  cfg.initialize();
+
+  char value[CONFIG_VALUE_LENGTH];
+  long offset = 0;
+  assertTrue(cfg.lookup("idle.show", value, sizeof(value), &offset));
+  assertEqual(0, strcmp("running", value));
+  assertEqual((long)strstr(BUTTONS, "running") - (long)BUTTONS, offset);
+}
+
+test(lookupWithoutIndexScans)
+{
+  writeFile("buttons.cfg", BUTTONS);
+  SD.remove("buttons.idx");
+  ConfigIndex cfg = ConfigIndex("buttons.cfg", "buttons.idx");
+
+  char value[CONFIG_VALUE_LENGTH];
+  long offset = 0;
+  assertTrue(cfg.lookup("1", value, sizeof(value), &offset));
+  assertEqual(0, strcmp("GLOBI/GOLD", value));
+  assertEqual((long)strstr(BUTTONS, "GLOBI/GOLD") - (long)BUTTONS, offset);
+}
+
+/*
+ * A line appended after the index was built (e.g. a learned tag) is found by a scan.
+ */
+test(lookupAddedKeyScans)
+{
+  writeFile("nfc.cfg", "04DEAD01=\n04A1B2C3=ALBUM\n");
+  ConfigIndex cfg = ConfigIndex("nfc.cfg", "nfc.idx");
+  cfg.initialize();
+  appendFile("nfc.cfg", "04BEEF02=\n04DEAD01=GLOBI/ZOO\n04BEEF02=GLOBI/GOLD\n");
+
+  char value[CONFIG_VALUE_LENGTH];
+  long offset;
+  assertTrue(cfg.lookup("04beef02", value, sizeof(value), &offset));
+  assertEqual(0, strcmp("GLOBI/GOLD", value));
+  assertEqual(63L, offset);
+  assertFalse(cfg.lookup("04DEAD01", value, sizeof(value), &offset));    // indexed, not scanned
+  assertEqual(9L, offset);
+  assertFalse(cfg.lookup("04C0FFEE", value, sizeof(value), &offset));
+  assertEqual(-1L, offset);
+}
+
+test(rebuildOnlyWhenChanged)
+{
+  writeFile("buttons.cfg", BUTTONS);
+  ConfigIndex cfg = ConfigIndex("buttons.cfg", "buttons.idx");
+  cfg.initialize();
+
+  Serial.clearOutput();
+  cfg.initialize();
+  assertEqual(NULL, strstr(Serial.output(), "Build index"));
+
+  appendFile("buttons.cfg", "\n2=GLOBI/PIRATEN\n");
+  cfg.initialize();
+  assertNotEqual(NULL, strstr(Serial.output(), "Build index"));
+  char value[CONFIG_VALUE_LENGTH];
+  assertTrue(cfg.lookup("2", value, sizeof(value)));
+  assertEqual(0, strcmp("GLOBI/PIRATEN", value));
+}
+
+test(rebuildWhenEditedInPlace)
+{
+  writeFile("buttons.cfg", BUTTONS);
+  ConfigIndex cfg = ConfigIndex("buttons.cfg", "buttons.idx");
+  cfg.initialize();
+
+  char edited[sizeof(BUTTONS)];
+  strcpy(edited, BUTTONS);
+  memcpy(strstr(edited, "\n1=") + 1, "2", 1);    // same size
+  writeFile("buttons.cfg", edited);
+  Serial.clearOutput();
+  cfg.initialize();
+  assertNotEqual(NULL, strstr(Serial.output(), "Build index"));
+  char value[CONFIG_VALUE_LENGTH];
+  assertTrue(cfg.lookup("2", value, sizeof(value)));
+  assertEqual(0, strcmp("GLOBI/GOLD", value));
+}
+
+test(invalidIndexRebuilt)
+{
+  writeFile("buttons.cfg", BUTTONS);
+  writeFile("buttons.idx", "MBI0 interrupted build");
+  ConfigIndex cfg = ConfigIndex("buttons.cfg", "buttons.idx");
+  Serial.clearOutput();
+  cfg.initialize();
+  assertNotEqual(NULL, strstr(Serial.output(), "Build index"));
+}
+
+/*
+ * Ids of mixed length over several index sectors, each found with a few reads.
+ */
+test(lookupManyTags)
+{
+  const uint16_t COUNT = 1000;    // 32 sorted runs, merged in 5 passes
+  SD.remove("nfc.cfg");
+  File file = SD.open("nfc.cfg", FILE_WRITE);
+  file.print(F("// Assign each NFC tag (identifier) a file or folder\n"));
+  for (uint16_t i = 0; i < COUNT; i++) {
+    uint32_t n = (uint32_t)i * 2654435761UL;
+    char line[48];
+    if (i % 2) {
+      snprintf(line, sizeof(line), "04%08lX%04X=ALBUM/%u\n", (unsigned long)n, i, i);
+    } else {
+      snprintf(line, sizeof(line), "%08lX=TRACK/%u.MP3\n", (unsigned long)n, i);
+    }
+    file.write(line);
+  }
+  file.close();
+  ConfigIndex cfg = ConfigIndex("nfc.cfg", "nfc.idx");
+  SD.stats = SdStats();
+  cfg.initialize();
+  assertLess(SD.stats.blocks, 2U * COUNT);    // a few sequential passes, not seeks per entry
+
+  for (uint16_t i = 0; i < COUNT; i++) {
+    uint32_t n = (uint32_t)i * 2654435761UL;
+    char key[16];
+    char expected[CONFIG_VALUE_LENGTH];
+    if (i % 2) {
+      snprintf(key, sizeof(key), "04%08lX%04X", (unsigned long)n, i);
+      snprintf(expected, sizeof(expected), "ALBUM/%u", i);
+    } else {
+      snprintf(key, sizeof(key), "%08lx", (unsigned long)n);    // lower case
+      snprintf(expected, sizeof(expected), "TRACK/%u.MP3", i);
+    }
+    char value[CONFIG_VALUE_LENGTH];
+    SD.stats = SdStats();
+    assertTrue(cfg.lookup(key, value, sizeof(value)));
+    assertEqual(0, strcmp(expected, value));
+    assertEqual(2U, SD.stats.opens);    // index and configuration
+    assertLessOrEqual(SD.stats.seeks, 13U);    // 32 fences, entries of one sector, value
+  }
+}
+
+test(readValueAtOffset)
+{
+  writeFile("buttons.cfg", BUTTONS);
+  ConfigIndex cfg = ConfigIndex("buttons.cfg", "buttons.idx");
+  cfg.initialize();
+
+  char value[CONFIG_VALUE_LENGTH];
+  long offset;
+  assertTrue(cfg.lookup("15", value, sizeof(value), &offset));
+  value[0] = '\0';
+  assertTrue(cfg.readValue(offset, value, sizeof(value)));
+  assertEqual(0, strcmp("PINGU", value));
+  assertFalse(cfg.readValue(sizeof(BUTTONS) + 10, value, sizeof(value)));
+}
+
+test(longValueTruncated)
+{
+  char line[CONFIG_VALUE_LENGTH + 20];
+  memset(line, 'A', sizeof(line) - 1);
+  line[sizeof(line) - 1] = '\0';
+  memcpy(line, "1=", 2);
+  writeFile("long.cfg", line);
+  appendFile("long.cfg", "\n2=012345678901234567890123456789012345678901234567890123456789012   \n");
+
+  char value[CONFIG_VALUE_LENGTH];
+  ConfigIndex cfg = ConfigIndex("long.cfg", "long.idx");
+  cfg.initialize();
+  Serial.clearOutput();
+  assertTrue(cfg.lookup("2", value, sizeof(value)));     // 63 chars and blanks
+  assertEqual(63, (int)strlen(value));
+  assertEqual(0, strcmp("", Serial.output()));
+  assertTrue(cfg.lookup("1", value, sizeof(value)));
+  assertEqual(63, (int)strlen(value));
+  assertEqual(0, strcmp("Value truncated in long.cfg, max. length 63\r\n", Serial.output()));
+
+  Serial.clearOutput();
+  ConfigIndex scanned = ConfigIndex("long.cfg", "missing.idx");
+  assertTrue(scanned.lookup("1", value, sizeof(value)));
+  assertEqual(63, (int)strlen(value));
+  assertEqual(0, strcmp("Value truncated in long.cfg, max. length 63\r\n", Serial.output()));
+}
+
+void loop() {
+  Test::run();
+}
@@ -0,0 +1,132 @@
+/*
+ * Host tests of the PN532 library over I2C (PN532_I2C) against the emulated PN532.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <ArduinoUnit.h>
+#include <PN532Device.h>
+#include <PN532_I2C.h>
+#include <PN532.h>
+
+#define LOOP_WORK_MICROS   1000    // keys, encoder and animation of a loop pass
+
+PN532Device device(4);
+PN532_I2C pn532i2c(Wire);
+PN532 nfc(pn532i2c);
+
+const uint8_t UID[] = { 0x04, 0xA1, 0xB2, 0xC3 };
+const uint8_t UID7[] = { 0x04, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 };
+
+
+uint32_t transactions() {
+  return Wire.stats.transmissions + Wire.stats.requests;
+}
+
+
+/*
+ * Longest pass of a main loop running for the given time, the latency until
+ * a pressed key is read. The nfc reader is polled once per pass (if given),
+ * it is expected to be pending all the time.
+ */
+unsigned long longestPass(unsigned long ms, int8_t (*pollNfc)()) {
+  unsigned long longest = 0;
+  unsigned long end = millis() + ms;
+  while ((long)(millis() - end) < 0) {
+    unsigned long start = micros();
+    if (pollNfc && pollNfc() != PN532_PENDING) return (unsigned long)-1;
+    advanceMicros(LOOP_WORK_MICROS);
+    longest = max(longest, micros() - start);
+  }
+  return longest;
+}
+
+int8_t pollTarget() {
+  uint8_t uid[7];
+  uint8_t length;
+  return nfc.pollPassiveTargetID(uid, &length);
+}
+
+void setup() {
+  Serial.begin(9600);
+  nfc.begin();
+  nfc.SAMConfig();
+}
+
+test(blockingReadFreezesLoop)
+{
+  uint8_t uid[7];
+  uint8_t length;
+  unsigned long start = millis();
+  assertFalse(nfc.readPassiveTargetID(PN532_MIFARE_ISO14443A, uid, &length, 1000));
+  assertMoreOrEqual(millis() - start, 1000UL);   // no key read meanwhile
+}
+
+test(keyLatencyFlatWhileNfcBusy)
+{
+  unsigned long idle = longestPass(1000, NULL);
+  assertTrue(nfc.beginPassiveTargetID(PN532_MIFARE_ISO14443A));
+  unsigned long first = longestPass(1000, pollTarget);   // no card, pending
+  unsigned long later = longestPass(3000, pollTarget);
+  assertLess(first, idle + 1000);   // ACK and status read in the first pass
+  assertLess(later, idle + 200);    // status read only (2 bytes)
+}
+
+test(splitPhaseReadsCard)
+{
+  assertTrue(nfc.beginPassiveTargetID(PN532_MIFARE_ISO14443A));
+  uint8_t uid[7];
+  uint8_t length;
+  assertEqual(PN532_PENDING, nfc.pollPassiveTargetID(uid, &length));
+  device.present(UID, sizeof(UID));
+  assertEqual(1, nfc.pollPassiveTargetID(uid, &length));
+  assertEqual(4, length);
+  assertEqual(0, memcmp(UID, uid, length));
+  device.remove();
+}
+
+test(responseReadInOneRequest)
+{
+  uint32_t before = transactions();
+  uint32_t nacks = device.stats.nacks;
+  assertEqual(0x32010607UL, nfc.getFirmwareVersion());
+  assertEqual(4U, transactions() - before);    // command, ACK, status, response
+  assertEqual(nacks, device.stats.nacks);
+}
+
+test(readPageInOneRequest)
+{
+  device.present(UID7, sizeof(UID7), PN532Device::ultralightUri("ALBUM"));
+  assertTrue(nfc.startAutoPoll(PN532_AUTOPOLL_ENDLESS, 1, PN532_AUTOPOLL_MIFARE));
+  uint8_t uid[7];
+  uint8_t length;
+  while (nfc.pollAutoPollTarget(uid, &length) == PN532_PENDING) delay(1);
+
+  uint32_t before = transactions();
+  uint32_t nacks = device.stats.nacks;
+  uint8_t page[4];
+  assertTrue(nfc.mifareultralight_ReadPage(3, page));   // capability container
+  assertEqual(0xE1, page[0]);
+  assertEqual(4U, transactions() - before);
+  assertEqual(nacks, device.stats.nacks);
+  device.remove();
+}
+
+test(unknownResponseRequestedAgain)
+{
+  uint32_t before = transactions();
+  uint32_t nacks = device.stats.nacks;
+  const uint8_t header[] = { 0x04 };   // GetGeneralStatus, response size unknown to the transport
+  assertEqual(0, nfc.beginCommand(header, sizeof(header)));
+  int16_t length;
+  while ((length = nfc.poll()) == PN532_PENDING) delay(1);
+  assertEqual(0, length);
+  assertEqual(nacks + 1, device.stats.nacks);
+  assertEqual(6U, transactions() - before);    // command, ACK, status, header, NACK, response
+}
+
+void loop() {
+  Test::run();
+}
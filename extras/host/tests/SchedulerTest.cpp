@@ -0,0 +1,154 @@
+/*
+ * Host tests of Scheduler, especially across the rollover of millis() (32 bit).
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <ArduinoUnit.h>
+#include "Scheduler.h"
+
+#define ROLLOVER   0xFFFFFFFFUL
+
+unsigned long ran[SCHEDULER_TASKS];
+byte order[8];
+byte runs;
+
+void record(byte task, unsigned long now) {
+  ran[task] = now;
+  if (runs < sizeof(order)) order[runs] = task;
+  runs++;
+}
+
+void task0(unsigned long now) { record(0, now); }
+void task1(unsigned long now) { record(1, now); }
+void task2(unsigned long now) { record(2, now); }
+
+Scheduler scheduler;
+
+void reset(unsigned long now) {
+  setMillis(now);
+  scheduler = Scheduler();
+  scheduler.define(0, task0);
+  scheduler.define(1, task1);
+  scheduler.define(2, task2);
+  memset(ran, 0, sizeof(ran));
+  runs = 0;
+}
+
+void setup() {
+  Serial.begin(9600);
+}
+
+test(runWhenDue)
+{
+  reset(1000);
+  scheduler.after(0, 10);
+  scheduler.run(1009);
+  assertEqual(0, runs);
+  scheduler.run(1010);
+  assertEqual(1, runs);
+  assertEqual(1010UL, ran[0]);
+  scheduler.run(1020);
+  assertEqual(1, runs);     // once per schedule
+  assertFalse(scheduler.isScheduled(0));
+}
+
+test(runInTaskOrder)
+{
+  reset(0);
+  scheduler.at(2, 5);
+  scheduler.at(1, 5);
+  scheduler.at(0, 7);
+  scheduler.run(10);
+  assertEqual(3, runs);
+  assertEqual(0, order[0]);
+  assertEqual(1, order[1]);
+  assertEqual(2, order[2]);
+}
+
+test(cancelled)
+{
+  reset(0);
+  scheduler.at(0, 5);
+  scheduler.cancel(0);
+  scheduler.run(10);
+  assertEqual(0, runs);
+  assertEqual(-1L, scheduler.untilNext(10));
+}
+
+test(untilNext)
+{
+  reset(0);
+  assertEqual(-1L, scheduler.untilNext(0));
+  scheduler.at(0, 50);
+  scheduler.at(1, 20);
+  assertEqual(20L, scheduler.untilNext(0));
+  assertEqual(5L, scheduler.untilNext(15));
+  assertEqual(0L, scheduler.untilNext(25));    // overdue
+}
+
+test(atAcrossRollover)
+{
+  reset(ROLLOVER - 5);
+  scheduler.at(0, 4);            // 10ms after now, after the rollover
+  scheduler.run(ROLLOVER - 5);
+  scheduler.run(ROLLOVER);
+  scheduler.run(3);
+  assertEqual(0, runs);
+  scheduler.run(4);
+  assertEqual(1, runs);
+  assertEqual(4UL, ran[0]);
+}
+
+test(afterAcrossRollover)
+{
+  reset(ROLLOVER - 1);
+  scheduler.after(0, 100);
+  assertEqual(100L, scheduler.untilNext(millis()));
+  setMillis(ROLLOVER);
+  assertEqual(99L, scheduler.untilNext(millis()));
+  scheduler.run(millis());
+  assertEqual(0, runs);
+
+  delay(50);        // millis() rolled over
+  assertEqual(49UL, millis());
+  assertEqual(49L, scheduler.untilNext(millis()));
+  scheduler.run(millis());
+  assertEqual(0, runs);
+
+  delay(50);
+  assertEqual(0L, scheduler.untilNext(millis()));
+  scheduler.run(millis());
+  assertEqual(1, runs);
+  assertEqual(99UL, ran[0]);
+}
+
+test(overdueAcrossRollover)
+{
+  reset(ROLLOVER - 20);
+  scheduler.at(0, ROLLOVER - 10);
+  assertEqual(0L, scheduler.untilNext(5));     // overdue, not 49 days ahead
+  scheduler.run(5);
+  assertEqual(1, runs);
+}
+
+test(untilNextAcrossRollover)
+{
+  reset(ROLLOVER - 30);
+  scheduler.at(0, ROLLOVER - 10);
+  scheduler.at(1, 20);
+  assertEqual(20L, scheduler.untilNext(ROLLOVER - 30));
+  assertEqual(5L, scheduler.untilNext(ROLLOVER - 15));
+  scheduler.run(ROLLOVER - 10);
+  assertEqual(31L, scheduler.untilNext(ROLLOVER - 10));  // task 1 after the rollover
+  assertEqual(1L, scheduler.untilNext(19));
+  scheduler.run(20);
+  assertEqual(2, runs);
+  assertEqual(-1L, scheduler.untilNext(20));
+}
+
+void loop() {
+  Test::run();
+}
@@ -0,0 +1,197 @@
+/*
+ * Host test of the whole sketch (src.ino) with its classes and libraries, driving
+ * the emulated trellis, decoder and nfc reader. The tests run in order on a single
+ * boot of the music box, the SD card is the directory build/sd/SketchTest.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <ArduinoUnit.h>
+#include <Adafruit_Trellis.h>
+#include <Adafruit_VS1053.h>
+#include <PN532Device.h>
+#include "Matrix.h"
+#include "NfcReader.h"
+#include "Player.h"
+#include "ConfigIndex.h"
+#include "TrackList.h"
+
+#define TRACK_SIZE   6000    // 375ms at 128 kbit/s
+
+void setup();
+void loop();
+
+HT16K33* trellis;
+PN532Device* pn532;
+Adafruit_VS1053* vs1053;
+
+const uint8_t KNOWN_UID[] = { 0x04, 0xA1, 0xB2, 0xC3 };
+const uint8_t NEW_UID[] = { 0x04, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 };
+const uint8_t UNKNOWN_UID[] = { 0x04, 0xDE, 0xAD, 0x01 };
+
+
+void writeFile(const char* name, const char* text) {
+  File file = SD.open(name, FILE_WRITE);
+  file.write(text);
+  file.close();
+}
+
+void writeTrack(const char* name) {
+  File file = SD.open(name, FILE_WRITE);
+  for (int i = 0; i < TRACK_SIZE; i++) file.write((uint8_t)i);
+  file.close();
+}
+
+/*
+ * Run the main loop for the given time.
+ */
+void run(unsigned long ms) {
+  unsigned long end = millis() + ms;
+  while ((long)(millis() - end) < 0) {
+    loop();
+  }
+}
+
+bool printed(const char* text) {
+  return strstr(Serial.output(), text) != NULL;
+}
+
+unsigned int timesPrinted(const char* text) {
+  unsigned int n = 0;
+  for (const char* p = strstr(Serial.output(), text); p; p = strstr(p + 1, text)) n++;
+  return n;
+}
+
+void press(uint8_t key) {
+  trellis->press(key);
+  run(100);
+  trellis->release(key);
+}
+
+
+test(bootsIdle)
+{
+  assertTrue(printed("MusicBox setup"));
+  assertTrue(printed("PN532 initialized"));
+  run(3000);
+  assertMore(trellis->frames.size(), 10U);   // idle show
+  assertEqual(0x60, pn532->lastCommand);     // polling for cards
+  assertEqual(0U, vs1053->stats.bytesFed);
+}
+
+test(keyPlaysAlbum)
+{
+  Serial.clearOutput();
+  press(0);
+  assertTrue(printed("Playing album #0"));
+  assertTrue(printed("Track 0: ALBUM/01.MP3"));
+  assertEqual(0x16, pn532->lastCommand);     // nfc powered down while playing
+  run(1000);
+  assertEqual(2U * TRACK_SIZE, vs1053->stats.bytesFed);
+  assertTrue(printed("Ended album #0"));
+  assertMore(vs1053->interrupts, 0U);    // fed by the DREQ interrupt
+}
+
+test(knownTagPlays)
+{
+  Serial.clearOutput();
+  run(1500);    // back to idle, nfc enabled
+  uint32_t fed = vs1053->stats.bytesFed;
+  pn532->present(KNOWN_UID, sizeof(KNOWN_UID));
+  run(200);
+  pn532->remove();
+  assertTrue(printed("NFC UID: 0x04A1B2C3"));
+  assertTrue(printed("Playing ALBUM/02.MP3"));
+  run(500);
+  assertEqual(fed + TRACK_SIZE, vs1053->stats.bytesFed);
+}
+
+test(newTagLearned)
+{
+  Serial.clearOutput();
+  run(1500);
+  pn532->present(NEW_UID, sizeof(NEW_UID), PN532Device::ultralightUri("ALBUM/01.MP3"));
+  run(200);
+  pn532->remove();
+  assertTrue(printed("Learned nfc id 04112233445566"));
+  assertTrue(printed("Playing ALBUM/01.MP3"));
+
+  char value[CONFIG_VALUE_LENGTH];
+  ConfigIndex cfg = ConfigIndex("nfc.cfg", "nfc.idx");
+  cfg.initialize();   // like at the next startup
+  assertTrue(cfg.lookup("04112233445566", value, sizeof(value)));
+  assertEqual(0, strcmp("ALBUM/01.MP3", value));
+}
+
+test(learnedTagCached)
+{
+  Serial.clearOutput();
+  run(1500);
+  uint32_t commands = pn532->stats.commands;
+  pn532->present(NEW_UID, sizeof(NEW_UID));   // the path is not read again
+  run(200);
+  pn532->remove();
+  assertTrue(printed("Tag cache hits 1, misses 2"));
+  assertTrue(printed("Playing ALBUM/01.MP3"));
+  assertFalse(printed("Learned"));
+  assertLess(pn532->stats.commands - commands, 4U);   // no InDataExchange
+}
+
+test(missingTrackEndsAlbum)
+{
+  Serial.clearOutput();
+  run(1500);
+  // renamed with the same size, the track list is not rebuilt
+  rename(SD.hostPath("ALBUM/02.MP3").c_str(), SD.hostPath("ALBUM/00.MP3").c_str());
+  uint32_t fed = vs1053->stats.bytesFed;
+  press(0);
+  run(1000);
+  assertFalse(printed("Build track list"));
+  assertTrue(printed("Track 1: ALBUM/02.MP3"));
+  assertTrue(printed("Ended album #0"));
+  assertEqual(fed + TRACK_SIZE, vs1053->stats.bytesFed);
+  assertFalse(SD.exists("ALBUM/" TRACKLIST_NAME));   // rebuilt on the next start
+}
+
+test(unknownTagIgnoredUntilRemoved)
+{
+  Serial.clearOutput();
+  run(1500);
+  uint32_t cfgSize = SD.open("nfc.cfg").size();
+  pn532->present(UNKNOWN_UID, sizeof(UNKNOWN_UID));
+  run(2000);    // left on the box
+  assertEqual(1U, timesPrinted("NFC UID: 0x04DEAD01"));
+  assertEqual(1U, timesPrinted("Unknown nfc id 04DEAD01"));
+  cfgSize += strlen("04DEAD01=\n");
+  assertEqual(cfgSize, SD.open("nfc.cfg").size());   // id added to be configured
+  pn532->remove();
+  run(1000);
+  pn532->present(UNKNOWN_UID, sizeof(UNKNOWN_UID));
+  run(200);
+  pn532->remove();
+  assertEqual(2U, timesPrinted("NFC UID: 0x04DEAD01"));
+  assertEqual(cfgSize, SD.open("nfc.cfg").size());   // only once
+  run(1000);
+  assertEqual(0x60, pn532->lastCommand);     // polling again
+}
+
+
+int main() {
+  SD.mount("sd/SketchTest");
+  SD.mkdir("ALBUM");
+  writeTrack("ALBUM/01.MP3");
+  writeTrack("ALBUM/02.MP3");
+  writeFile("buttons.cfg", "0=ALBUM\n");
+  writeFile("nfc.cfg", "04A1B2C3=ALBUM/02.MP3\n");
+  writeFile("settings.cfg", "idle.show=pulsing\n");
+
+  setPin(HEADPHONE_LEVEL_PIN, 890);    // unplugged
+  trellis = new HT16K33(TRELLIS_ADDRESS);
+  trellis->connectInterrupt(TRELLIS_INT_PIN);
+  pn532 = new PN532Device(NFC_IRQ_PIN);
+  setup();
+  vs1053 = Adafruit_VS1053::instance;
+  Test::run();
+}
@@ -0,0 +1,155 @@
+/*
+ * Host tests of TagCache.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <ArduinoUnit.h>
+#include "TagCache.h"
+#include "ConfigIndex.h"
+
+TagId tag(uint32_t n) {
+  TagId id = { 4, { (byte)(n >> 24), (byte)(n >> 16), (byte)(n >> 8), (byte)n } };
+  return id;
+}
+
+void setup() {
+  Serial.begin(9600);
+}
+
+test(missWhenEmpty)
+{
+  TagCache cache;
+  assertEqual(-1L, cache.get(tag(1)));
+}
+
+test(hitAfterPut)
+{
+  TagCache cache;
+  cache.put(tag(1), 1234);
+  cache.put(tag(2), 0);
+  assertEqual(1234L, cache.get(tag(1)));
+  assertEqual(0L, cache.get(tag(2)));
+  assertEqual(-1L, cache.get(tag(3)));
+}
+
+test(putReplacesOffset)
+{
+  TagCache cache;
+  cache.put(tag(1), 10);
+  cache.put(tag(1), 20);
+  assertEqual(20L, cache.get(tag(1)));
+}
+
+test(uidLengthDistinguishes)
+{
+  TagCache cache;
+  TagId shortId = { 4, { 0x04, 0xC8, 0x0F, 0xEA } };
+  TagId longId = { 7, { 0x04, 0xC8, 0x0F, 0xEA, 0xA0, 0x65, 0x84 } };
+  cache.put(shortId, 1);
+  cache.put(longId, 2);
+  assertEqual(1L, cache.get(shortId));
+  assertEqual(2L, cache.get(longId));
+}
+
+test(invalidIdNotCached)
+{
+  TagCache cache;
+  TagId tooLong = { TAG_UID_LENGTH + 1 };
+  cache.put(tooLong, 2);
+  assertEqual(-1L, cache.get(tooLong));
+}
+
+/*
+ * More tags than slots: the recently used tags stay cached, a lookup never returns
+ * the offset of another tag.
+ */
+test(recentlyUsedStay)
+{
+  TagCache cache;
+  for (uint32_t n = 0; n < 200; n++) {
+    cache.put(tag(n), 1000 + n);
+    cache.get(tag(7));    // keep one tag in use
+    assertEqual(1000L + n, cache.get(tag(n)));
+  }
+  assertEqual(1007L, cache.get(tag(7)));
+
+  int cached = 0;
+  for (uint32_t n = 0; n < 200; n++) {
+    long offset = cache.get(tag(n));
+    if (offset >= 0) {
+      assertEqual(1000L + n, offset);
+      cached++;
+    }
+  }
+  assertMore(cached, 1);
+  assertLessOrEqual(cached, TAG_CACHE_SIZE);
+}
+
+test(emptyIdNotCached)
+{
+  TagCache cache;
+  TagId empty = { 0 };
+  cache.put(empty, 1);
+  assertEqual(-1L, cache.get(empty));   // does not match an empty slot
+}
+
+test(pathCached)
+{
+  TagCache cache;
+  char path[CONFIG_VALUE_LENGTH] = "junk";
+  assertEqual(-1L, cache.get(tag(1), path, sizeof(path)));
+  assertEqual(0, strcmp("", path));
+
+  cache.put(tag(1), 100, "GLOBI/SPORT");
+  assertEqual(100L, cache.get(tag(1), path, sizeof(path)));
+  assertEqual(0, strcmp("GLOBI/SPORT", path));
+  assertEqual(100L, cache.get(tag(1)));
+}
+
+test(longPathByOffset)
+{
+  TagCache cache;
+  char path[CONFIG_VALUE_LENGTH];
+  cache.put(tag(1), 100, "12345678901234567890123");      // fits
+  cache.put(tag(2), 200, "123456789012345678901234");     // too long
+  assertEqual(100L, cache.get(tag(1), path, sizeof(path)));
+  assertEqual(23, (int)strlen(path));
+  assertEqual(200L, cache.get(tag(2), path, sizeof(path)));
+  assertEqual(0, strcmp("", path));    // read at the offset
+
+  cache.put(tag(1), 300);               // replaced without path
+  assertEqual(300L, cache.get(tag(1), path, sizeof(path)));
+  assertEqual(0, strcmp("", path));
+
+  char small[8];
+  cache.put(tag(3), 400, "GLOBI/SPORT");
+  assertEqual(400L, cache.get(tag(3), small, sizeof(small)));
+  assertEqual(0, strcmp("", small));   // does not fit the buffer
+}
+
+test(clearRemovesAll)
+{
+  TagCache cache;
+  cache.put(tag(1), 1);
+  cache.clear();
+  assertEqual(-1L, cache.get(tag(1)));
+}
+
+test(statistics)
+{
+  TagCache cache;
+  cache.put(tag(1), 1);
+  cache.get(tag(1));
+  cache.get(tag(1));
+  cache.get(tag(2));
+  Serial.clearOutput();
+  cache.printStatistics();
+  assertEqual(0, strcmp("Tag cache hits 2, misses 1\r\n", Serial.output()));
+}
+
+void loop() {
+  Test::run();
+}
@@ -0,0 +1,60 @@
+/*
+ * Host tests of TagId.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <ArduinoUnit.h>
+#include "TagId.h"
+
+void setup() {
+  Serial.begin(9600);
+}
+
+test(hexOfFourBytes)
+{
+  TagId id = { 4, { 0x98, 0x33, 0xA9, 0x3A } };
+  char hex[TAG_HEX_LENGTH];
+  assertEqual(0, strcmp("9833A93A", id.toHex(hex)));
+}
+
+test(hexOfSevenBytes)
+{
+  TagId id = { 7, { 0x04, 0x7C, 0x2B, 0x92, 0xB5, 0x51, 0x80 } };
+  char hex[TAG_HEX_LENGTH];
+  assertEqual(0, strcmp("047C2B92B55180", id.toHex(hex)));
+  assertEqual(TAG_HEX_LENGTH - 1, (int)strlen(hex));
+}
+
+test(hexOfEmpty)
+{
+  TagId id = { 0 };
+  char hex[TAG_HEX_LENGTH] = "garbage";
+  assertEqual(0, strcmp("", id.toHex(hex)));
+}
+
+test(hexBoundedByBuffer)
+{
+  TagId id = { 10, { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07 } };
+  char hex[TAG_HEX_LENGTH + 4];
+  memset(hex, 'x', sizeof(hex));
+  assertEqual(0, strcmp("01020304050607", id.toHex(hex)));
+  assertEqual('x', hex[TAG_HEX_LENGTH]);
+}
+
+test(equalByLengthAndUid)
+{
+  TagId a = { 4, { 0x01, 0x02, 0x03, 0x04, 0xAA } };
+  TagId b = { 4, { 0x01, 0x02, 0x03, 0x04, 0xBB } };
+  TagId c = { 5, { 0x01, 0x02, 0x03, 0x04, 0xAA } };
+  TagId d = { 4, { 0x01, 0x02, 0x03, 0x05 } };
+  assertTrue(a == b);    // bytes beyond the length are ignored
+  assertFalse(a == c);
+  assertFalse(a == d);
+}
+
+void loop() {
+  Test::run();
+}
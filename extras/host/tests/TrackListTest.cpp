@@ -0,0 +1,168 @@
+/*
+ * Host tests of TrackList, the SD card is the directory build/sd/TrackListTest.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include <ArduinoUnit.h>
+#include "TrackList.h"
+
+void writeFile(const char* name, size_t size) {
+  SD.remove(name);
+  File file = SD.open(name, FILE_WRITE);
+  for (size_t i = 0; i < size; i++) file.write((uint8_t)i);
+  file.close();
+}
+
+void writeAlbum() {
+  SD.remove("ALBUM/" TRACKLIST_NAME);
+  writeFile("ALBUM/03.MP3", 300);
+  writeFile("ALBUM/01.MP3", 100);
+  writeFile("ALBUM/COVER.JPG", 50);
+  writeFile("ALBUM/02.OGG", 200);
+}
+
+bool built() {
+  bool result = strstr(Serial.output(), "Build track list") != NULL;
+  Serial.clearOutput();
+  return result;
+}
+
+void setup() {
+  Serial.begin(9600);
+  SD.mount("sd/TrackListTest");
+  SD.mkdir("ALBUM");
+}
+
+test(listedInNameOrder)
+{
+  writeAlbum();
+  TrackList tracks;
+  assertTrue(tracks.open("ALBUM"));
+  assertTrue(built());
+  assertEqual(3, tracks.count());
+
+  char name[TRACK_NAME_LENGTH + 1];
+  assertTrue(tracks.getName(0, name));
+  assertEqual(0, strcmp("01.MP3", name));
+  assertTrue(tracks.getName(1, name));
+  assertEqual(0, strcmp("02.OGG", name));
+  assertTrue(tracks.getName(2, name));
+  assertEqual(0, strcmp("03.MP3", name));
+  assertFalse(tracks.getName(3, name));
+  tracks.close();
+}
+
+test(listReused)
+{
+  writeAlbum();
+  TrackList tracks;
+  assertTrue(tracks.open("ALBUM/"));
+  assertTrue(built());
+  tracks.close();
+
+  SD.stats = SdStats();
+  assertTrue(tracks.open("ALBUM/"));
+  assertFalse(built());
+  assertEqual(0U, SD.stats.bytesWritten);
+  assertEqual(2U, SD.stats.opens);    // list and folder, no track
+  assertEqual(3, tracks.count());
+  tracks.close();
+}
+
+test(rebuiltWhenTrackAdded)
+{
+  writeAlbum();
+  TrackList tracks;
+  assertTrue(tracks.open("ALBUM"));
+  assertTrue(built());
+  tracks.close();
+
+  writeFile("ALBUM/00.MP3", 10);
+  assertTrue(tracks.open("ALBUM"));
+  assertTrue(built());
+  assertEqual(4, tracks.count());
+  char name[TRACK_NAME_LENGTH + 1];
+  assertTrue(tracks.getName(0, name));
+  assertEqual(0, strcmp("00.MP3", name));
+  tracks.close();
+  SD.remove("ALBUM/00.MP3");
+}
+
+test(rebuiltWhenTrackRemoved)
+{
+  writeAlbum();
+  TrackList tracks;
+  assertTrue(tracks.open("ALBUM"));
+  assertTrue(built());
+  tracks.close();
+
+  SD.remove("ALBUM/02.OGG");
+  assertTrue(tracks.open("ALBUM"));
+  assertTrue(built());
+  assertEqual(2, tracks.count());
+  tracks.close();
+}
+
+test(rebuiltWhenTrackReplaced)
+{
+  writeAlbum();
+  TrackList tracks;
+  assertTrue(tracks.open("ALBUM"));
+  assertTrue(built());
+  tracks.close();
+
+  // same number of tracks, e.g. another album copied into the folder
+  SD.remove("ALBUM/03.MP3");
+  writeFile("ALBUM/04.MP3", 400);
+  assertTrue(tracks.open("ALBUM"));
+  assertTrue(built());
+  char name[TRACK_NAME_LENGTH + 1];
+  assertTrue(tracks.getName(2, name));
+  assertEqual(0, strcmp("04.MP3", name));
+  tracks.close();
+  SD.remove("ALBUM/04.MP3");
+}
+
+test(otherFilesIgnored)
+{
+  writeAlbum();
+  TrackList tracks;
+  assertTrue(tracks.open("ALBUM"));
+  assertTrue(built());
+  tracks.close();
+
+  writeFile("ALBUM/NOTES.TXT", 20);
+  assertTrue(tracks.open("ALBUM"));
+  assertFalse(built());
+  tracks.close();
+  SD.remove("ALBUM/NOTES.TXT");
+}
+
+test(invalidListRebuilt)
+{
+  writeAlbum();
+  TrackList tracks;
+  assertTrue(tracks.open("ALBUM"));
+  assertTrue(built());
+  tracks.close();
+
+  writeFile("ALBUM/" TRACKLIST_NAME, 8);
+  assertTrue(tracks.open("ALBUM"));
+  assertTrue(built());
+  assertEqual(3, tracks.count());
+  tracks.close();
+}
+
+test(missingAlbum)
+{
+  TrackList tracks;
+  assertFalse(tracks.open("NOALBUM"));
+  assertEqual(0, tracks.count());
+}
+
+void loop() {
+  Test::run();
+}
@@ -15,59 +15,98 @@ MifareClassic::~MifareClassic()
 {
 }
 
-NfcTag MifareClassic::read(byte *uid, unsigned int uidLength)
+// the records are decoded into the arena, or the heap without arena
+NfcTag MifareClassic::read(byte *uid, unsigned int uidLength, NdefArena *arena)
+{
+    // fixed buffer, the TLV length read from the tag can't be trusted
+    uint8_t buffer[MIFARE_CLASSIC_BUFFER_SIZE];
+
+    int messageLength = readMessage(uid, uidLength, buffer, sizeof(buffer));
+    if (messageLength == MIFARE_CLASSIC_TLV_ERROR)
+    {
+        return NfcTag(uid, uidLength, "ERROR"); // TODO should the error message go in NfcTag?
+    }
+    else if (messageLength < 0)
+    {
+        return NfcTag(uid, uidLength, MIFARE_CLASSIC);
+    }
+    return NfcTag(uid, uidLength, MIFARE_CLASSIC, buffer, messageLength, arena);
+}
+
+// Read the message without decoding it (see NdefMessageView), the message is
+// moved to the start of the buffer. The buffer needs room for the TLV header
+// and full blocks.
+int MifareClassic::readMessage(byte *uid, unsigned int uidLength, byte *buffer, unsigned int size)
 {
     uint8_t key[6] = { 0xD3, 0xF7, 0xD3, 0xF7, 0xD3, 0xF7 };
     int currentBlock = 4;
     int messageStartIndex = 0;
     int messageLength = 0;
-    byte data[BLOCK_SIZE];
 
-    // read first block to get message length
+    if (size < BLOCK_SIZE)
+    {
+        return MIFARE_CLASSIC_READ_ERROR;
+    }
+
+    // read first block to get message length, the sector stays authenticated
     int success = _nfcShield->mifareclassic_AuthenticateBlock(uid, uidLength, currentBlock, 0, key);
     if (success)
     {
-        success = _nfcShield->mifareclassic_ReadDataBlock(currentBlock, data);
+        success = _nfcShield->mifareclassic_ReadDataBlock(currentBlock, buffer);
         if (success)
         {
-            if (!decodeTlv(data, messageLength, messageStartIndex)) {
-                return NfcTag(uid, uidLength, "ERROR"); // TODO should the error message go in NfcTag?
+            if (!decodeTlv(buffer, messageLength, messageStartIndex)) {
+                return MIFARE_CLASSIC_TLV_ERROR;
             }
         }
         else
         {
             Serial.print(F("Error. Failed read block "));Serial.println(currentBlock);
-            return NfcTag(uid, uidLength, MIFARE_CLASSIC);
+            return MIFARE_CLASSIC_READ_ERROR;
         }
     }
     else
     {
         Serial.println(F("Tag is not NDEF formatted."));
         // TODO set tag.isFormatted = false
-        return NfcTag(uid, uidLength, MIFARE_CLASSIC);
+        return MIFARE_CLASSIC_READ_ERROR;
     }
 
-    // this should be nested in the message length loop
-    int index = 0;
-    int bufferSize = getBufferSize(messageLength);
-    uint8_t buffer[bufferSize];
+    // only full blocks are read into the buffer
+    int messageEnd = messageStartIndex + messageLength;
+    if (messageEnd > (int)(size - size % BLOCK_SIZE))
+    {
+        Serial.print(F("Error. Message too long "));Serial.println(messageLength);
+        return MIFARE_CLASSIC_READ_ERROR;
+    }
 
     #ifdef MIFARE_CLASSIC_DEBUG
     Serial.print(F("Message Length "));Serial.println(messageLength);
-    Serial.print(F("Buffer Size "));Serial.println(bufferSize);
     #endif
 
-    while (index < bufferSize)
+    // continue after the first block, stop when the message is complete
+    // (the terminator TLV is not needed)
+    int index = BLOCK_SIZE;
+    currentBlock++;
+    while (index < messageEnd)
     {
+        // skip the trailer block
+        if (_nfcShield->mifareclassic_IsTrailerBlock(currentBlock))
+        {
+            #ifdef MIFARE_CLASSIC_DEBUG
+            Serial.print(F("Skipping block "));Serial.println(currentBlock);
+            #endif
+            currentBlock++;
+        }
 
-        // authenticate on every sector
+        // authenticate once per sector
         if (_nfcShield->mifareclassic_IsFirstBlock(currentBlock))
         {
             success = _nfcShield->mifareclassic_AuthenticateBlock(uid, uidLength, currentBlock, 0, key);
             if (!success)
             {
                 Serial.print(F("Error. Block Authentication failed for "));Serial.println(currentBlock);
-                // TODO error handling
+                return MIFARE_CLASSIC_READ_ERROR;
             }
         }
 
@@ -83,23 +122,15 @@ NfcTag MifareClassic::read(byte *uid, unsigned int uidLength)
         else
         {
             Serial.print(F("Read failed "));Serial.println(currentBlock);
-            // TODO handle errors here
+            return MIFARE_CLASSIC_READ_ERROR;
         }
 
         index += BLOCK_SIZE;
         currentBlock++;
-
-        // skip the trailer block
-        if (_nfcShield->mifareclassic_IsTrailerBlock(currentBlock))
-        {
-            #ifdef MIFARE_CLASSIC_DEBUG
-            Serial.print(F("Skipping block "));Serial.println(currentBlock);
-            #endif
-            currentBlock++;
-        }
     }
 
-    return NfcTag(uid, uidLength, MIFARE_CLASSIC, &buffer[messageStartIndex], messageLength);
+    memmove(buffer, &buffer[messageStartIndex], messageLength);
+    return messageLength;
 }
 
 int MifareClassic::getBufferSize(int messageLength)
@@ -6,12 +6,21 @@
 #include <Ndef.h>
 #include <NfcTag.h>
 
+// Read buffer, longer messages are rejected (multiple of 16 bytes)
+#define MIFARE_CLASSIC_BUFFER_SIZE 256
+
+// Errors of readMessage()
+#define MIFARE_CLASSIC_READ_ERROR (-1)
+#define MIFARE_CLASSIC_TLV_ERROR (-2)
+
 class MifareClassic
 {
     public:
         MifareClassic(PN532& nfcShield);
         ~MifareClassic();
-        NfcTag read(byte *uid, unsigned int uidLength);
+        NfcTag read(byte *uid, unsigned int uidLength, NdefArena *arena = (NdefArena *)NULL);
+        // read the encoded message into the buffer, returns its length or a negative error
+        int readMessage(byte *uid, unsigned int uidLength, byte *buffer, unsigned int size);
         boolean write(NdefMessage& ndefMessage, byte *uid, unsigned int uidLength);
         boolean formatNDEF(byte * uid, unsigned int uidLength);
         boolean formatMifare(byte * uid, unsigned int uidLength);
@@ -1,7 +1,7 @@
 #include <MifareUltralight.h>
 
 #define ULTRALIGHT_PAGE_SIZE 4
-#define ULTRALIGHT_READ_SIZE 4 // we should be able to read 16 bytes at a time
+#define ULTRALIGHT_READ_SIZE 16 // the read command returns 4 pages
 
 #define ULTRALIGHT_DATA_START_PAGE 4
 #define ULTRALIGHT_MESSAGE_LENGTH_INDEX 1
@@ -21,7 +21,8 @@ MifareUltralight::~MifareUltralight()
 {
 }
 
-NfcTag MifareUltralight::read(byte * uid, unsigned int uidLength)
+// the records are decoded into the arena, or the heap without arena
+NfcTag MifareUltralight::read(byte * uid, unsigned int uidLength, NdefArena *arena)
 {
     if (isUnformatted())
     {
@@ -39,46 +40,92 @@ NfcTag MifareUltralight::read(byte * uid, unsigned int uidLength)
         return NfcTag(uid, uidLength, NFC_FORUM_TAG_TYPE_2, message);
     }
 
+    byte buffer[readBufferSize()];
+    if (!readData(buffer))
+    {
+        // TODO error handling
+        messageLength = 0;
+    }
+
+    return NfcTag(uid, uidLength, NFC_FORUM_TAG_TYPE_2, &buffer[ndefStartIndex], messageLength, arena);
+
+}
+
+// Read the message without decoding it (see NdefMessageView), the message is
+// moved to the start of the buffer. The buffer needs room for the TLV header
+// and the full read commands.
+int MifareUltralight::readMessage(byte *buffer, unsigned int size)
+{
+    if (isUnformatted())
+    {
+        Serial.println(F("WARNING: Tag is not formatted."));
+        return -1;
+    }
+
+    readCapabilityContainer(); // meta info for tag
+    findNdefMessage();
+    calculateBufferSize();
+
+    if (messageLength == 0)
+    {
+        return 0;
+    }
+    if (readBufferSize() > size)
+    {
+        Serial.print(F("Error. Message too long "));Serial.println(messageLength);
+        return -1;
+    }
+    if (!readData(buffer))
+    {
+        return -1;
+    }
+
+    memmove(buffer, &buffer[ndefStartIndex], messageLength);
+    return messageLength;
+}
+
+// buffer size to read the message in full read commands
+unsigned int MifareUltralight::readBufferSize()
+{
+    return ((bufferSize + ULTRALIGHT_READ_SIZE - 1) / ULTRALIGHT_READ_SIZE) * ULTRALIGHT_READ_SIZE;
+}
+
+// read the pages holding the message into the buffer of readBufferSize()
+boolean MifareUltralight::readData(byte *buffer)
+{
     boolean success;
     uint8_t page;
-    uint8_t index = 0;
-    byte buffer[bufferSize];
-    for (page = ULTRALIGHT_DATA_START_PAGE; page < ULTRALIGHT_MAX_PAGE; page++)
+    unsigned int index = 0;
+    for (page = ULTRALIGHT_DATA_START_PAGE; page < ULTRALIGHT_MAX_PAGE; page += ULTRALIGHT_READ_SIZE / ULTRALIGHT_PAGE_SIZE)
     {
         // read the data
-        success = nfc->mifareultralight_ReadPage(page, &buffer[index]);
+        success = nfc->mifareultralight_ReadPages(page, &buffer[index]);
         if (success)
         {
             #ifdef MIFARE_ULTRALIGHT_DEBUG
-            Serial.print(F("Page "));Serial.print(page);Serial.print(" ");
-            nfc->PrintHexChar(&buffer[index], ULTRALIGHT_PAGE_SIZE);
+            Serial.print(F("Pages "));Serial.print(page);Serial.print(" ");
+            nfc->PrintHexChar(&buffer[index], ULTRALIGHT_READ_SIZE);
             #endif
         }
         else
         {
             Serial.print(F("Read failed "));Serial.println(page);
-            // TODO error handling
-            messageLength = 0;
-            break;
+            return false;
         }
 
+        index += ULTRALIGHT_READ_SIZE;
         if (index >= (messageLength + ndefStartIndex))
         {
             break;
         }
-
-        index += ULTRALIGHT_PAGE_SIZE;
     }
-
-    NdefMessage ndefMessage = NdefMessage(&buffer[ndefStartIndex], messageLength);
-    return NfcTag(uid, uidLength, NFC_FORUM_TAG_TYPE_2, ndefMessage);
-
+    return true;
 }
 
 boolean MifareUltralight::isUnformatted()
 {
     uint8_t page = 4;
-    byte data[ULTRALIGHT_READ_SIZE];
+    byte data[ULTRALIGHT_PAGE_SIZE];
     boolean success = nfc->mifareultralight_ReadPage (page, data);
     if (success)
     {
@@ -111,21 +158,15 @@ void MifareUltralight::readCapabilityContainer()
 // read enough of the message to find the ndef message length
 void MifareUltralight::findNdefMessage()
 {
-    int page;
-    byte data[12]; // 3 pages
-    byte* data_ptr = &data[0];
+    int page = 4;
+    byte data[ULTRALIGHT_READ_SIZE]; // 4 pages
 
-    // the nxp read command reads 4 pages, unfortunately adafruit give me one page at a time
-    boolean success = true;
-    for (page = 4; page < 6; page++)
-    {
-        success = success && nfc->mifareultralight_ReadPage(page, data_ptr);
-        #ifdef MIFARE_ULTRALIGHT_DEBUG
-        Serial.print(F("Page "));Serial.print(page);Serial.print(F(" - "));
-        nfc->PrintHexChar(data_ptr, 4);
-        #endif
-        data_ptr += ULTRALIGHT_PAGE_SIZE;
-    }
+    // the nxp read command reads 4 pages at once
+    boolean success = nfc->mifareultralight_ReadPages(page, data);
+    #ifdef MIFARE_ULTRALIGHT_DEBUG
+    Serial.print(F("Pages "));Serial.print(page);Serial.print(F(" - "));
+    nfc->PrintHexChar(data, ULTRALIGHT_READ_SIZE);
+    #endif
 
     if (success)
     {
@@ -155,10 +196,10 @@ void MifareUltralight::calculateBufferSize()
     // TLV terminator 0xFE is 1 byte
     bufferSize = messageLength + ndefStartIndex + 1;
 
-    if (bufferSize % ULTRALIGHT_READ_SIZE != 0)
+    if (bufferSize % ULTRALIGHT_PAGE_SIZE != 0)
     {
         // buffer must be an increment of page size
-        bufferSize = ((bufferSize / ULTRALIGHT_READ_SIZE) + 1) * ULTRALIGHT_READ_SIZE;
+        bufferSize = ((bufferSize / ULTRALIGHT_PAGE_SIZE) + 1) * ULTRALIGHT_PAGE_SIZE;
     }
 }
 
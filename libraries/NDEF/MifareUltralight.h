@@ -10,7 +10,9 @@ class MifareUltralight
     public:
         MifareUltralight(PN532& nfcShield);
         ~MifareUltralight();
-        NfcTag read(byte *uid, unsigned int uidLength);
+        NfcTag read(byte *uid, unsigned int uidLength, NdefArena *arena = (NdefArena *)NULL);
+        // read the encoded message into the buffer, returns its length or -1
+        int readMessage(byte *buffer, unsigned int size);
         boolean write(NdefMessage& ndefMessage, byte *uid, unsigned int uidLength);
         boolean clean();
     private:
@@ -23,6 +25,8 @@ class MifareUltralight
         void readCapabilityContainer();
         void findNdefMessage();
         void calculateBufferSize();
+        unsigned int readBufferSize();
+        boolean readData(byte *buffer);
 };
 
 #endif
@@ -0,0 +1,55 @@
+#include <NdefArena.h>
+
+NdefArena::NdefArena(byte *buffer, unsigned int size)
+{
+    _buffer = buffer;
+    _size = size;
+    _used = 0;
+    _peak = 0;
+    _failures = 0;
+}
+
+byte* NdefArena::allocate(unsigned int numBytes)
+{
+    if (numBytes > _size - _used)
+    {
+        _failures++;
+        return (byte *)NULL;
+    }
+
+    byte *memory = &_buffer[_used];
+    _used += numBytes;
+    if (_used > _peak)
+    {
+        _peak = _used;
+    }
+    return memory;
+}
+
+// all records allocated from the arena must be gone (or not used anymore)
+void NdefArena::release()
+{
+    _used = 0;
+}
+
+unsigned int NdefArena::getSize()
+{
+    return _size;
+}
+
+unsigned int NdefArena::getUsed()
+{
+    return _used;
+}
+
+// highest use since the arena was created
+unsigned int NdefArena::getPeak()
+{
+    return _peak;
+}
+
+// allocations that did not fit
+unsigned int NdefArena::getFailures()
+{
+    return _failures;
+}
@@ -0,0 +1,34 @@
+#ifndef NdefArena_h
+#define NdefArena_h
+
+#include <Arduino.h>
+
+/**
+ * Bump allocator over a caller supplied buffer for the type, id and payload of
+ * NdefRecords. Nothing is freed individually, release() frees everything at once
+ * when the messages and tags using the arena are gone. This keeps the heap from
+ * fragmenting when many tags are read or written.
+ */
+class NdefArena
+{
+    public:
+        NdefArena(byte *buffer, unsigned int size);
+
+        // NULL when the arena is full
+        byte* allocate(unsigned int numBytes);
+        void release();
+
+        unsigned int getSize();
+        unsigned int getUsed();
+        unsigned int getPeak();
+        unsigned int getFailures();
+
+    private:
+        byte* _buffer;
+        unsigned int _size;
+        unsigned int _used;
+        unsigned int _peak;
+        unsigned int _failures;
+};
+
+#endif
@@ -3,9 +3,17 @@
 NdefMessage::NdefMessage(void)
 {
     _recordCount = 0;
+    useArena((NdefArena *)NULL);
 }
 
-NdefMessage::NdefMessage(const byte * data, const int numBytes)
+// the records are allocated from the arena instead of the heap
+NdefMessage::NdefMessage(NdefArena& arena)
+{
+    _recordCount = 0;
+    useArena(&arena);
+}
+
+NdefMessage::NdefMessage(const byte * data, const int numBytes, NdefArena *arena)
 {
     #ifdef NDEF_DEBUG
     Serial.print(F("Decoding "));Serial.print(numBytes);Serial.println(F(" bytes"));
@@ -14,6 +22,7 @@ NdefMessage::NdefMessage(const byte * data, const int numBytes)
     #endif
 
     _recordCount = 0;
+    useArena(arena);
 
     int index = 0;
 
@@ -30,7 +39,13 @@ NdefMessage::NdefMessage(const byte * data, const int numBytes)
         bool il = (tnf_byte & 0x8) != 0;
         byte tnf = (tnf_byte & 0x7);
 
-        NdefRecord record = NdefRecord();
+        // decode straight into the message, the record is not copied
+        if (_recordCount >= MAX_NDEF_RECORDS)
+        {
+            Serial.println(F("WARNING: Too many records. Increase MAX_NDEF_RECORDS."));
+            break;
+        }
+        NdefRecord& record = _records[_recordCount];
         record.setTnf(tnf);
 
         index++;
@@ -71,16 +86,18 @@ NdefMessage::NdefMessage(const byte * data, const int numBytes)
         record.setPayload(&data[index], payloadLength);
         index += payloadLength;
 
-        addRecord(record);
+        _recordCount++;
 
         if (me) break; // last message
     }
 
 }
 
+// a copy uses the same arena (or the heap) as the original
 NdefMessage::NdefMessage(const NdefMessage& rhs)
 {
 
+    useArena(rhs._arena);
     _recordCount = rhs._recordCount;
     for (int i = 0; i < _recordCount; i++)
     {
@@ -93,6 +110,29 @@ NdefMessage::~NdefMessage()
 {
 }
 
+void NdefMessage::useArena(NdefArena *arena)
+{
+    _arena = arena;
+    for (int i = 0; i < MAX_NDEF_RECORDS; i++)
+    {
+        _records[i]._arena = arena;
+    }
+}
+
+// next unused record, NULL if the message is full
+NdefRecord* NdefMessage::nextRecord()
+{
+    if (_recordCount < MAX_NDEF_RECORDS)
+    {
+        return &_records[_recordCount++];
+    }
+    else
+    {
+        Serial.println(F("WARNING: Too many records. Increase MAX_NDEF_RECORDS."));
+        return (NdefRecord *)NULL;
+    }
+}
+
 NdefMessage& NdefMessage::operator=(const NdefMessage& rhs)
 {
 
@@ -172,16 +212,15 @@ void NdefMessage::addMimeMediaRecord(String mimeType, String payload)
 
 void NdefMessage::addMimeMediaRecord(String mimeType, uint8_t* payload, int payloadLength)
 {
-    NdefRecord r = NdefRecord();
-    r.setTnf(TNF_MIME_MEDIA);
+    NdefRecord* r = nextRecord();
+    if (!r) return;
+    r->setTnf(TNF_MIME_MEDIA);
 
     byte type[mimeType.length() + 1];
     mimeType.getBytes(type, sizeof(type));
-    r.setType(type, mimeType.length());
-
-    r.setPayload(payload, payloadLength);
+    r->setType(type, mimeType.length());
 
-    addRecord(r);
+    r->setPayload(payload, payloadLength);
 }
 
 void NdefMessage::addTextRecord(String text)
@@ -191,11 +230,12 @@ void NdefMessage::addTextRecord(String text)
 
 void NdefMessage::addTextRecord(String text, String encoding)
 {
-    NdefRecord r = NdefRecord();
-    r.setTnf(TNF_WELL_KNOWN);
+    NdefRecord* r = nextRecord();
+    if (!r) return;
+    r->setTnf(TNF_WELL_KNOWN);
 
     uint8_t RTD_TEXT[1] = { 0x54 }; // TODO this should be a constant or preprocessor
-    r.setType(RTD_TEXT, sizeof(RTD_TEXT));
+    r->setType(RTD_TEXT, sizeof(RTD_TEXT));
 
     // X is a placeholder for encoding length
     // TODO is it more efficient to build w/o string concatenation?
@@ -207,14 +247,13 @@ void NdefMessage::addTextRecord(String text, String encoding)
     // replace X with the real encoding length
     payload[0] = encoding.length();
 
-    r.setPayload(payload, payloadString.length());
-
-    addRecord(r);
+    r->setPayload(payload, payloadString.length());
 }
 
 void NdefMessage::addUriRecord(String uri)
 {
-    NdefRecord* r = new NdefRecord();
+    NdefRecord* r = nextRecord();
+    if (!r) return;
     r->setTnf(TNF_WELL_KNOWN);
 
     uint8_t RTD_URI[1] = { 0x55 }; // TODO this should be a constant or preprocessor
@@ -230,17 +269,13 @@ void NdefMessage::addUriRecord(String uri)
     payload[0] = 0x0;
 
     r->setPayload(payload, payloadString.length());
-
-    addRecord(*r);
-    delete(r);
 }
 
 void NdefMessage::addEmptyRecord()
 {
-    NdefRecord* r = new NdefRecord();
+    NdefRecord* r = nextRecord();
+    if (!r) return;
     r->setTnf(TNF_EMPTY);
-    addRecord(*r);
-    delete(r);
 }
 
 NdefRecord NdefMessage::getRecord(int index)
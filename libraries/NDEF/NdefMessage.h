@@ -10,7 +10,8 @@ class NdefMessage
 {
     public:
         NdefMessage(void);
-        NdefMessage(const byte *data, const int numBytes);
+        NdefMessage(NdefArena& arena);
+        NdefMessage(const byte *data, const int numBytes, NdefArena *arena = (NdefArena *)NULL);
         NdefMessage(const NdefMessage& rhs);
         ~NdefMessage();
         NdefMessage& operator=(const NdefMessage& rhs);
@@ -32,8 +33,11 @@ class NdefMessage
 
         void print();
     private:
+        void useArena(NdefArena *arena);
+        NdefRecord* nextRecord();
         NdefRecord _records[MAX_NDEF_RECORDS];
         unsigned int _recordCount;
+        NdefArena* _arena; // NULL = heap
 };
 
 #endif
\ No newline at end of file
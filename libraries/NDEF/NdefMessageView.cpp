@@ -0,0 +1,137 @@
+#include <NdefMessageView.h>
+
+NdefRecordView::NdefRecordView()
+{
+    _tnf = 0;
+    _last = true;
+    _type = NULL;
+    _id = NULL;
+    _payload = NULL;
+    _typeLength = 0;
+    _idLength = 0;
+    _payloadLength = 0;
+}
+
+byte NdefRecordView::getTnf() const
+{
+    return _tnf;
+}
+
+unsigned int NdefRecordView::getTypeLength() const
+{
+    return _typeLength;
+}
+
+unsigned int NdefRecordView::getIdLength() const
+{
+    return _idLength;
+}
+
+unsigned int NdefRecordView::getPayloadLength() const
+{
+    return _payloadLength;
+}
+
+const byte* NdefRecordView::getType() const
+{
+    return _type;
+}
+
+const byte* NdefRecordView::getId() const
+{
+    return _id;
+}
+
+const byte* NdefRecordView::getPayload() const
+{
+    return _payload;
+}
+
+// message end flag of the record
+boolean NdefRecordView::isLast() const
+{
+    return _last;
+}
+
+NdefMessageView::NdefMessageView(const byte *data, unsigned int numBytes)
+{
+    _data = data;
+    _numBytes = data ? numBytes : 0;
+    rewind();
+}
+
+void NdefMessageView::rewind()
+{
+    _index = 0;
+    _valid = true;
+    _done = _numBytes == 0;
+}
+
+boolean NdefMessageView::isValid() const
+{
+    return _valid;
+}
+
+// decode the next record into the view, see NdefMessage(const byte*, int) for the format
+boolean NdefMessageView::next(NdefRecordView& record)
+{
+    if (_done)
+    {
+        return false;
+    }
+
+    // tnf with bit flags, type length, payload length (1 or 4 bytes), id length (optional)
+    byte tnf_byte = _data[_index];
+    boolean sr = (tnf_byte & 0x10) != 0;
+    boolean il = (tnf_byte & 0x8) != 0;
+    unsigned int headerLength = 2 + (sr ? 1 : 4) + (il ? 1 : 0);
+    if (headerLength > _numBytes - _index)
+    {
+        _done = true;
+        _valid = false;
+        return false;
+    }
+
+    const byte *header = &_data[_index + 1];
+    unsigned long typeLength = *header++;
+    unsigned long payloadLength;
+    if (sr)
+    {
+        payloadLength = *header++;
+    }
+    else
+    {
+        payloadLength = ((unsigned long)header[0] << 24) | ((unsigned long)header[1] << 16)
+                | ((unsigned long)header[2] << 8) | header[3];
+        header += 4;
+    }
+    unsigned long idLength = il ? *header++ : 0;
+
+    // the remaining buffer is checked for each field, the sum could overflow
+    unsigned int index = _index + headerLength;
+    unsigned int remaining = _numBytes - index;
+    if (typeLength > remaining
+            || idLength > remaining - typeLength
+            || payloadLength > remaining - typeLength - idLength)
+    {
+        _done = true;
+        _valid = false;
+        return false;
+    }
+
+    record._tnf = tnf_byte & 0x7;
+    record._last = (tnf_byte & 0x40) != 0;
+    record._typeLength = typeLength;
+    record._type = &_data[index];
+    index += typeLength;
+    record._idLength = idLength;
+    record._id = &_data[index];
+    index += idLength;
+    record._payloadLength = payloadLength;
+    record._payload = &_data[index];
+    index += payloadLength;
+
+    _index = index;
+    _done = record._last || _index >= _numBytes;
+    return true;
+}
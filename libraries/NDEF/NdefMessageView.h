@@ -0,0 +1,58 @@
+#ifndef NdefMessageView_h
+#define NdefMessageView_h
+
+#include <Ndef.h>
+
+/**
+ * A record of an encoded NDEF message. Type, id and payload point into the
+ * message buffer and are only valid as long as the buffer is, nothing is copied.
+ */
+class NdefRecordView
+{
+    public:
+        NdefRecordView();
+
+        byte getTnf() const;
+        unsigned int getTypeLength() const;
+        unsigned int getIdLength() const;
+        unsigned int getPayloadLength() const;
+        const byte* getType() const;
+        const byte* getId() const;
+        const byte* getPayload() const;
+        boolean isLast() const;
+
+    private:
+        friend class NdefMessageView;
+        byte _tnf;
+        boolean _last;
+        const byte* _type;
+        const byte* _id;
+        const byte* _payload;
+        unsigned int _typeLength;
+        unsigned int _idLength;
+        unsigned int _payloadLength;
+};
+
+/**
+ * Iterates the records of an encoded NDEF message without allocating memory.
+ * All lengths are checked against the end of the buffer, a malformed record
+ * ends the iteration and leaves the view invalid.
+ */
+class NdefMessageView
+{
+    public:
+        NdefMessageView(const byte *data, unsigned int numBytes);
+
+        boolean next(NdefRecordView& record);
+        boolean isValid() const;
+        void rewind();
+
+    private:
+        const byte* _data;
+        unsigned int _numBytes;
+        unsigned int _index;
+        boolean _valid;
+        boolean _done;
+};
+
+#endif
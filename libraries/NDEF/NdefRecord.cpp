@@ -3,6 +3,7 @@
 NdefRecord::NdefRecord()
 {
     //Serial.println("NdefRecord Constructor 1");
+    _arena = (NdefArena *)NULL;
     _tnf = 0;
     _typeLength = 0;
     _payloadLength = 0;
@@ -12,36 +13,32 @@ NdefRecord::NdefRecord()
     _id = (byte *)NULL;
 }
 
-NdefRecord::NdefRecord(const NdefRecord& rhs)
+// type, payload and id are allocated from the arena instead of the heap
+NdefRecord::NdefRecord(NdefArena& arena)
 {
-    //Serial.println("NdefRecord Constructor 2 (copy)");
-
-    _tnf = rhs._tnf;
-    _typeLength = rhs._typeLength;
-    _payloadLength = rhs._payloadLength;
-    _idLength = rhs._idLength;
+    _arena = &arena;
+    _tnf = 0;
+    _typeLength = 0;
+    _payloadLength = 0;
+    _idLength = 0;
     _type = (byte *)NULL;
     _payload = (byte *)NULL;
     _id = (byte *)NULL;
+}
 
-    if (_typeLength)
-    {
-        _type = (byte*)malloc(_typeLength);
-        memcpy(_type, rhs._type, _typeLength);
-    }
-
-    if (_payloadLength)
-    {
-        _payload = (byte*)malloc(_payloadLength);
-        memcpy(_payload, rhs._payload, _payloadLength);
-    }
-
-    if (_idLength)
-    {
-        _id = (byte*)malloc(_idLength);
-        memcpy(_id, rhs._id, _idLength);
-    }
+// a copy uses the same arena (or the heap) as the original
+NdefRecord::NdefRecord(const NdefRecord& rhs)
+{
+    //Serial.println("NdefRecord Constructor 2 (copy)");
 
+    _arena = rhs._arena;
+    _tnf = rhs._tnf;
+    _type = copy(rhs._type, rhs._typeLength);
+    _typeLength = _type ? rhs._typeLength : 0;
+    _payload = copy(rhs._payload, rhs._payloadLength);
+    _payloadLength = _payload ? rhs._payloadLength : 0;
+    _id = copy(rhs._id, rhs._idLength);
+    _idLength = _id ? rhs._idLength : 0;
 }
 
 // TODO NdefRecord::NdefRecord(tnf, type, payload, id)
@@ -51,20 +48,21 @@ NdefRecord::~NdefRecord()
     //Serial.println("NdefRecord Destructor");
     if (_typeLength)
     {
-        free(_type);
+        release(_type);
     }
 
     if (_payloadLength)
     {
-        free(_payload);
+        release(_payload);
     }
 
     if (_idLength)
     {
-        free(_id);
+        release(_id);
     }
 }
 
+// the record keeps its own arena (or the heap)
 NdefRecord& NdefRecord::operator=(const NdefRecord& rhs)
 {
     //Serial.println("NdefRecord ASSIGN");
@@ -74,43 +72,53 @@ NdefRecord& NdefRecord::operator=(const NdefRecord& rhs)
         // free existing
         if (_typeLength)
         {
-            free(_type);
+            release(_type);
         }
 
         if (_payloadLength)
         {
-            free(_payload);
+            release(_payload);
         }
 
         if (_idLength)
         {
-            free(_id);
+            release(_id);
         }
 
         _tnf = rhs._tnf;
-        _typeLength = rhs._typeLength;
-        _payloadLength = rhs._payloadLength;
-        _idLength = rhs._idLength;
+        _type = copy(rhs._type, rhs._typeLength);
+        _typeLength = _type ? rhs._typeLength : 0;
+        _payload = copy(rhs._payload, rhs._payloadLength);
+        _payloadLength = _payload ? rhs._payloadLength : 0;
+        _id = copy(rhs._id, rhs._idLength);
+        _idLength = _id ? rhs._idLength : 0;
+    }
+    return *this;
+}
 
-        if (_typeLength)
-        {
-            _type = (byte*)malloc(_typeLength);
-            memcpy(_type, rhs._type, _typeLength);
-        }
+// copy data to the arena or the heap, NULL if empty or out of memory
+byte* NdefRecord::copy(const byte *data, unsigned int numBytes)
+{
+    if (numBytes == 0)
+    {
+        return (byte *)NULL;
+    }
 
-        if (_payloadLength)
-        {
-            _payload = (byte*)malloc(_payloadLength);
-            memcpy(_payload, rhs._payload, _payloadLength);
-        }
+    byte *memory = _arena ? _arena->allocate(numBytes) : (byte*)malloc(numBytes);
+    if (memory)
+    {
+        memcpy(memory, data, numBytes);
+    }
+    return memory;
+}
 
-        if (_idLength)
-        {
-            _id = (byte*)malloc(_idLength);
-            memcpy(_id, rhs._id, _idLength);
-        }
+// memory of the arena is released all at once by the arena
+void NdefRecord::release(byte *data)
+{
+    if (!_arena)
+    {
+        free(data);
     }
-    return *this;
 }
 
 // size of records in bytes
@@ -251,12 +259,11 @@ void NdefRecord::setType(const byte * type, const unsigned int numBytes)
 {
     if(_typeLength)
     {
-        free(_type);
+        release(_type);
     }
 
-    _type = (uint8_t*)malloc(numBytes);
-    memcpy(_type, type, numBytes);
-    _typeLength = numBytes;
+    _type = copy(type, numBytes);
+    _typeLength = _type ? numBytes : 0;
 }
 
 // assumes the caller sized payload properly
@@ -269,12 +276,11 @@ void NdefRecord::setPayload(const byte * payload, const int numBytes)
 {
     if (_payloadLength)
     {
-        free(_payload);
+        release(_payload);
     }
 
-    _payload = (byte*)malloc(numBytes);
-    memcpy(_payload, payload, numBytes);
-    _payloadLength = numBytes;
+    _payload = copy(payload, numBytes);
+    _payloadLength = _payload ? numBytes : 0;
 }
 
 String NdefRecord::getId()
@@ -294,12 +300,11 @@ void NdefRecord::setId(const byte * id, const unsigned int numBytes)
 {
     if (_idLength)
     {
-        free(_id);
+        release(_id);
     }
 
-    _id = (byte*)malloc(numBytes);
-    memcpy(_id, id, numBytes);
-    _idLength = numBytes;
+    _id = copy(id, numBytes);
+    _idLength = _id ? numBytes : 0;
 }
 
 void NdefRecord::print()
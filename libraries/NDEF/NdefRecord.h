@@ -4,6 +4,7 @@
 #include <Due.h>
 #include <Arduino.h>
 #include <Ndef.h>
+#include <NdefArena.h>
 
 #define TNF_EMPTY 0x0
 #define TNF_WELL_KNOWN 0x01
@@ -18,6 +19,7 @@ class NdefRecord
 {
     public:
         NdefRecord();
+        NdefRecord(NdefArena& arena);
         NdefRecord(const NdefRecord& rhs);
         ~NdefRecord();
         NdefRecord& operator=(const NdefRecord& rhs);
@@ -45,7 +47,11 @@ class NdefRecord
 
         void print();
     private:
+        friend class NdefMessage;
         byte getTnfByte(bool firstRecord, bool lastRecord);
+        byte* copy(const byte *data, unsigned int numBytes);
+        void release(byte *data);
+        NdefArena* _arena; // NULL = heap
         byte _tnf; // 3 bit
         unsigned int _typeLength;
         int _payloadLength;
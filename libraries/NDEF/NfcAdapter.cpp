@@ -3,11 +3,22 @@
 NfcAdapter::NfcAdapter(PN532Interface &interface)
 {
     shield = new PN532(interface);
+    ownsShield = true;
+}
+
+NfcAdapter::NfcAdapter(PN532 &shield)
+{
+    this->shield = &shield;
+    ownsShield = false;
+    uidLength = 0;
 }
 
 NfcAdapter::~NfcAdapter(void)
 {
-    delete shield;
+    if (ownsShield)
+    {
+        delete shield;
+    }
 }
 
 void NfcAdapter::begin(boolean verbose)
@@ -102,6 +113,17 @@ boolean NfcAdapter::clean()
 
 
 NfcTag NfcAdapter::read()
+{
+    return readTag((NdefArena *)NULL);
+}
+
+// decode the records into the arena instead of the heap
+NfcTag NfcAdapter::read(NdefArena& arena)
+{
+    return readTag(&arena);
+}
+
+NfcTag NfcAdapter::readTag(NdefArena *arena)
 {
     uint8_t type = guessTagType();
 
@@ -111,7 +133,7 @@ NfcTag NfcAdapter::read()
         Serial.println(F("Reading Mifare Classic"));
         #endif
         MifareClassic mifareClassic = MifareClassic(*shield);
-        return mifareClassic.read(uid, uidLength);
+        return mifareClassic.read(uid, uidLength, arena);
     }
     else if (type == TAG_TYPE_2)
     {
@@ -119,7 +141,7 @@ NfcTag NfcAdapter::read()
         Serial.println(F("Reading Mifare Ultralight"));
         #endif
         MifareUltralight ultralight = MifareUltralight(*shield);
-        return ultralight.read(uid, uidLength);
+        return ultralight.read(uid, uidLength, arena);
     }
     else if (type == TAG_TYPE_UNKNOWN)
     {
@@ -135,6 +157,48 @@ NfcTag NfcAdapter::read()
 
 }
 
+// read the tag with the given uid, which has already been selected (e.g. by InAutoPoll)
+NfcTag NfcAdapter::read(const byte *uid, unsigned int uidLength)
+{
+    if (uidLength > sizeof(this->uid))
+    {
+        uidLength = sizeof(this->uid);
+    }
+    memcpy(this->uid, uid, uidLength);
+    this->uidLength = uidLength;
+    return read();
+}
+
+// read the encoded message of the selected tag into the buffer without decoding it,
+// iterate its records with NdefMessageView. Returns the message length or -1.
+int NfcAdapter::readMessage(const byte *uid, unsigned int uidLength, byte *buffer, unsigned int size)
+{
+    if (uidLength > sizeof(this->uid))
+    {
+        uidLength = sizeof(this->uid);
+    }
+    memcpy(this->uid, uid, uidLength);
+    this->uidLength = uidLength;
+
+    uint8_t type = guessTagType();
+    if (type == TAG_TYPE_MIFARE_CLASSIC)
+    {
+        MifareClassic mifareClassic = MifareClassic(*shield);
+        int length = mifareClassic.readMessage(this->uid, this->uidLength, buffer, size);
+        return length < 0 ? -1 : length;
+    }
+    else if (type == TAG_TYPE_2)
+    {
+        MifareUltralight ultralight = MifareUltralight(*shield);
+        return ultralight.readMessage(buffer, size);
+    }
+    else
+    {
+        Serial.print(F("No driver for card type "));Serial.println(type);
+        return -1;
+    }
+}
+
 boolean NfcAdapter::write(NdefMessage& ndefMessage)
 {
     boolean success;
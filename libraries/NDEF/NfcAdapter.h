@@ -5,6 +5,7 @@
 #include <PN532.h>
 #include <NfcTag.h>
 #include <Ndef.h>
+#include <NdefMessageView.h>
 
 // Drivers
 #include <MifareClassic.h>
@@ -23,11 +24,16 @@
 class NfcAdapter {
     public:
         NfcAdapter(PN532Interface &interface);
+        // use an initialized shield, e.g. to read a tag found by autonomous polling
+        NfcAdapter(PN532 &shield);
 
         ~NfcAdapter(void);
         void begin(boolean verbose=true);
         boolean tagPresent(unsigned long timeout=0); // tagAvailable
         NfcTag read();
+        NfcTag read(NdefArena& arena);
+        NfcTag read(const byte *uid, unsigned int uidLength);
+        int readMessage(const byte *uid, unsigned int uidLength, byte *buffer, unsigned int size);
         boolean write(NdefMessage& ndefMessage);
         // erase tag by writing an empty NDEF record
         boolean erase();
@@ -37,9 +43,11 @@ class NfcAdapter {
         boolean clean();
     private:
         PN532* shield;
+        boolean ownsShield;
         byte uid[7];  // Buffer to store the returned UID
         unsigned int uidLength; // Length of the UID (4 or 7 bytes depending on ISO14443A card type)
         unsigned int guessTagType();
+        NfcTag readTag(NdefArena *arena);
 };
 
 #endif
@@ -5,7 +5,7 @@ NfcTag::NfcTag()
     _uid = 0;
     _uidLength = 0;
     _tagType = "Unknown";
-    _ndefMessage = (NdefMessage*)NULL;
+    _hasNdefMessage = false;
 }
 
 NfcTag::NfcTag(byte *uid, unsigned int uidLength)
@@ -13,7 +13,7 @@ NfcTag::NfcTag(byte *uid, unsigned int uidLength)
     _uid = uid;
     _uidLength = uidLength;
     _tagType = "Unknown";
-    _ndefMessage = (NdefMessage*)NULL;
+    _hasNdefMessage = false;
 }
 
 NfcTag::NfcTag(byte *uid, unsigned int  uidLength, String tagType)
@@ -21,41 +21,43 @@ NfcTag::NfcTag(byte *uid, unsigned int  uidLength, String tagType)
     _uid = uid;
     _uidLength = uidLength;
     _tagType = tagType;
-    _ndefMessage = (NdefMessage*)NULL;
+    _hasNdefMessage = false;
 }
 
+// the copy of the message uses the same arena (or the heap)
 NfcTag::NfcTag(byte *uid, unsigned int  uidLength, String tagType, NdefMessage& ndefMessage)
+    : _ndefMessage(ndefMessage)
 {
     _uid = uid;
     _uidLength = uidLength;
     _tagType = tagType;
-    _ndefMessage = new NdefMessage(ndefMessage);
+    _hasNdefMessage = true;
 }
 
 // I don't like this version, but it will use less memory
-NfcTag::NfcTag(byte *uid, unsigned int uidLength, String tagType, const byte *ndefData, const int ndefDataLength)
+// (the records are decoded into the arena if there is one)
+NfcTag::NfcTag(byte *uid, unsigned int uidLength, String tagType, const byte *ndefData, const int ndefDataLength, NdefArena *arena)
+    : _ndefMessage(ndefData, ndefDataLength, arena)
 {
     _uid = uid;
     _uidLength = uidLength;
     _tagType = tagType;
-    _ndefMessage = new NdefMessage(ndefData, ndefDataLength);
+    _hasNdefMessage = true;
 }
 
 NfcTag::~NfcTag()
 {
-    delete _ndefMessage;
 }
 
 NfcTag& NfcTag::operator=(const NfcTag& rhs)
 {
     if (this != &rhs)
     {
-        delete _ndefMessage;
         _uid = rhs._uid;
         _uidLength = rhs._uidLength;
         _tagType = rhs._tagType;
-        // TODO do I need a copy here?
         _ndefMessage = rhs._ndefMessage;
+        _hasNdefMessage = rhs._hasNdefMessage;
     }
     return *this;
 }
@@ -98,24 +100,24 @@ String NfcTag::getTagType()
 
 boolean NfcTag::hasNdefMessage()
 {
-    return (_ndefMessage != NULL);
+    return _hasNdefMessage;
 }
 
 NdefMessage NfcTag::getNdefMessage()
 {
-    return *_ndefMessage;
+    return _ndefMessage;
 }
 
 void NfcTag::print()
 {
     Serial.print(F("NFC Tag - "));Serial.println(_tagType);
     Serial.print(F("UID "));Serial.println(getUidString());
-    if (_ndefMessage == NULL)
+    if (!_hasNdefMessage)
     {
         Serial.println(F("\nNo NDEF Message"));
     }
     else
     {
-        _ndefMessage->print();
+        _ndefMessage.print();
     }
 }
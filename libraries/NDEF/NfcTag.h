@@ -12,7 +12,7 @@ class NfcTag
         NfcTag(byte *uid, unsigned int uidLength);
         NfcTag(byte *uid, unsigned int uidLength, String tagType);
         NfcTag(byte *uid, unsigned int uidLength, String tagType, NdefMessage& ndefMessage);
-        NfcTag(byte *uid, unsigned int uidLength, String tagType, const byte *ndefData, const int ndefDataLength);
+        NfcTag(byte *uid, unsigned int uidLength, String tagType, const byte *ndefData, const int ndefDataLength, NdefArena *arena = (NdefArena *)NULL);
         ~NfcTag(void);
         NfcTag& operator=(const NfcTag& rhs);
         uint8_t getUidLength();
@@ -26,7 +26,8 @@ class NfcTag
         byte *_uid;
         unsigned int _uidLength;
         String _tagType; // Mifare Classic, NFC Forum Type {1,2,3,4}, Unknown
-        NdefMessage* _ndefMessage;
+        NdefMessage _ndefMessage; // held by value, only the records may use the heap
+        boolean _hasNdefMessage;
         // TODO capacity
         // TODO isFormatted
 };
@@ -0,0 +1,106 @@
+#include <Wire.h>
+#include <PN532.h>
+#include <NdefArena.h>
+#include <NdefMessage.h>
+#include <NfcTag.h>
+#include <ArduinoUnit.h>
+
+// text record "en" "Unit" followed by an uri record with id "x"
+const byte encoded[] = {
+  0x91, 0x01, 0x07, 0x54, 0x02, 0x65, 0x6e, 0x55, 0x6e, 0x69, 0x74,
+  0x59, 0x01, 0x04, 0x01, 0x55, 0x78, 0x00, 0x61, 0x2e, 0x6d
+};
+byte uid[] = { 0x01, 0x02, 0x03, 0x04 };
+
+void setup() {
+  Serial.begin(9600);
+}
+
+test(arenaAllocate)
+{
+  byte buffer[8];
+  NdefArena arena = NdefArena(buffer, sizeof(buffer));
+
+  assertTrue(arena.allocate(5) == buffer);
+  assertTrue(arena.allocate(3) == &buffer[5]);
+  assertTrue(arena.allocate(1) == NULL);
+  assertEqual(8, arena.getUsed());
+  assertEqual(1, arena.getFailures());
+
+  arena.release();
+  assertEqual(0, arena.getUsed());
+  assertEqual(8, arena.getPeak());
+}
+
+test(arenaDecode)
+{
+  byte buffer[64];
+  NdefArena arena = NdefArena(buffer, sizeof(buffer));
+  int start = freeMemory();
+
+  if (true) // bogus block so automatic storage duration objects are deleted
+  {
+    NdefMessage message = NdefMessage(encoded, sizeof(encoded), &arena);
+    assertEqual(2, message.getRecordCount());
+    // T + payload, U + id + payload
+    assertEqual(14, arena.getUsed());
+    assertEqual(sizeof(encoded), message.getEncodedSize());
+  }
+
+  assertEqual(0, (start - freeMemory()));
+  arena.release();
+}
+
+test(arenaWrite)
+{
+  byte buffer[64];
+  NdefArena arena = NdefArena(buffer, sizeof(buffer));
+  int start = freeMemory();
+
+  if (true)
+  {
+    NdefMessage message = NdefMessage(arena);
+    message.addTextRecord("Unit");
+    message.addUriRecord("a.m");
+    assertEqual(2, message.getRecordCount());
+    assertTrue(arena.getUsed() > 0);
+  }
+
+  assertEqual(0, (start - freeMemory()));
+  arena.release();
+}
+
+test(arenaFull)
+{
+  byte buffer[10];
+  NdefArena arena = NdefArena(buffer, sizeof(buffer));
+
+  // the payload of the second record does not fit, it is left empty
+  NdefMessage message = NdefMessage(encoded, sizeof(encoded), &arena);
+  assertEqual(2, message.getRecordCount());
+  assertEqual(sizeof(encoded) - 4, message.getEncodedSize());
+  assertTrue(arena.getFailures() > 0);
+}
+
+// read the same tag over and over, the heap must not change
+test(arenaSoak)
+{
+  byte buffer[64];
+  NdefArena arena = NdefArena(buffer, sizeof(buffer));
+  int start = freeMemory();
+
+  for (int i = 0; i < 1000; i++)
+  {
+    NfcTag tag = NfcTag(uid, sizeof(uid), "Mifare Classic", encoded, sizeof(encoded), &arena);
+    assertTrue(tag.hasNdefMessage());
+    arena.release();
+  }
+
+  assertEqual(0, (start - freeMemory()));
+  assertEqual(0, arena.getFailures());
+  Serial.print(F("Arena peak "));Serial.println(arena.getPeak());
+}
+
+void loop() {
+  Test::run();
+}
@@ -0,0 +1,118 @@
+#include <Wire.h>
+#include <PN532.h>
+#include <NdefMessage.h>
+#include <NdefMessageView.h>
+#include <ArduinoUnit.h>
+
+// text record "en" "Unit" followed by an uri record with id "x"
+const byte encoded[] = {
+  0x91, 0x01, 0x07, 0x54, 0x02, 0x65, 0x6e, 0x55, 0x6e, 0x69, 0x74,
+  0x59, 0x01, 0x04, 0x01, 0x55, 0x78, 0x00, 0x61, 0x2e, 0x6d
+};
+
+void assertBytesEqual(const uint8_t* expected, const uint8_t* actual, int size) {
+  for (int i = 0; i < size; i++) {
+    assertEqual(expected[i], actual[i]);
+  }
+}
+
+void setup() {
+  Serial.begin(9600);
+}
+
+test(viewRecords)
+{
+  NdefMessageView message = NdefMessageView(encoded, sizeof(encoded));
+  NdefRecordView record;
+
+  assertTrue(message.next(record));
+  assertEqual(TNF_WELL_KNOWN, record.getTnf());
+  assertEqual(1, record.getTypeLength());
+  assertEqual(0x54, record.getType()[0]);
+  assertEqual(0, record.getIdLength());
+  assertEqual(7, record.getPayloadLength());
+  assertBytesEqual(&encoded[4], record.getPayload(), 7);
+  assertFalse(record.isLast());
+
+  assertTrue(message.next(record));
+  assertEqual(0x55, record.getType()[0]);
+  assertEqual(1, record.getIdLength());
+  assertEqual(0x78, record.getId()[0]);
+  assertEqual(4, record.getPayloadLength());
+  assertBytesEqual(&encoded[17], record.getPayload(), 4);
+  assertTrue(record.isLast());
+
+  assertFalse(message.next(record));
+  assertTrue(message.isValid());
+}
+
+test(viewMatchesMessage)
+{
+  NdefMessage decoded = NdefMessage(encoded, sizeof(encoded));
+  NdefMessageView message = NdefMessageView(encoded, sizeof(encoded));
+  NdefRecordView view;
+
+  for (unsigned int i = 0; i < decoded.getRecordCount(); i++) {
+    NdefRecord record = decoded.getRecord(i);
+    assertTrue(message.next(view));
+    assertEqual(record.getTnf(), view.getTnf());
+    assertEqual(record.getTypeLength(), view.getTypeLength());
+    assertEqual(record.getPayloadLength(), view.getPayloadLength());
+    byte payload[record.getPayloadLength()];
+    record.getPayload(payload);
+    assertBytesEqual(payload, view.getPayload(), sizeof(payload));
+  }
+  assertFalse(message.next(view));
+}
+
+test(viewTruncated)
+{
+  // payload and header cut off
+  for (unsigned int length = 1; length < 11; length++) {
+    NdefMessageView message = NdefMessageView(encoded, length);
+    NdefRecordView record;
+    assertFalse(message.next(record));
+    assertFalse(message.isValid());
+  }
+
+  // first record complete, second one cut off
+  NdefMessageView message = NdefMessageView(encoded, sizeof(encoded) - 1);
+  NdefRecordView record;
+  assertTrue(message.next(record));
+  assertFalse(message.next(record));
+  assertFalse(message.isValid());
+}
+
+test(viewLongPayloadLength)
+{
+  // 4 byte payload length exceeding the buffer
+  const byte data[] = { 0xC1, 0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0x54, 0x00 };
+  NdefMessageView message = NdefMessageView(data, sizeof(data));
+  NdefRecordView record;
+  assertFalse(message.next(record));
+  assertFalse(message.isValid());
+}
+
+test(viewRewind)
+{
+  NdefMessageView message = NdefMessageView(encoded, sizeof(encoded));
+  NdefRecordView record;
+  while (message.next(record));
+  message.rewind();
+  assertTrue(message.next(record));
+  assertEqual(0x54, record.getType()[0]);
+}
+
+test(viewNoAllocation)
+{
+  int start = freeMemory();
+  NdefMessageView message = NdefMessageView(encoded, sizeof(encoded));
+  NdefRecordView record;
+  while (message.next(record));
+  int end = freeMemory();
+  assertEqual(0, (start - end));
+}
+
+void loop() {
+  Test::run();
+}
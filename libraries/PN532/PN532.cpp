@@ -307,7 +307,7 @@ bool PN532::SAMConfig(void)
     if (HAL(writeCommand)(pn532_packetbuffer, 4))
         return false;
 
-    return (0 < HAL(readResponse)(pn532_packetbuffer, sizeof(pn532_packetbuffer)));
+    return (0 <= HAL(readResponse)(pn532_packetbuffer, sizeof(pn532_packetbuffer)));   // no response data
 }
 
 /**************************************************************************/
@@ -334,6 +334,34 @@ bool PN532::setPassiveActivationRetries(uint8_t maxRetries)
     return (0 < HAL(readResponse)(pn532_packetbuffer, sizeof(pn532_packetbuffer)));
 }
 
+/**************************************************************************/
+/*!
+    Puts the PN532 into power down mode, a command in progress is aborted.
+    The configuration (e.g. SAMConfig) is kept.
+
+    @param  wakeupEnable  Wake up sources (e.g. PN532_WAKEUP_I2C)
+
+    @returns 1 if everything executed properly, 0 for an error
+*/
+/**************************************************************************/
+bool PN532::powerDown(uint8_t wakeupEnable)
+{
+    HAL(abortCommand)();
+
+    pn532_packetbuffer[0] = PN532_COMMAND_POWERDOWN;
+    pn532_packetbuffer[1] = wakeupEnable;
+
+    DMSG("PowerDown\n");
+
+    if (HAL(writeCommand)(pn532_packetbuffer, 2))
+        return 0x0;  // no ACK
+
+    if (HAL(readResponse)(pn532_packetbuffer, sizeof(pn532_packetbuffer)) < 0)
+        return 0x0;
+
+    return (0 == (pn532_packetbuffer[0] & 0x3F));  // status
+}
+
 /***** ISO14443A Commands ******/
 
 /**************************************************************************/
@@ -398,6 +426,148 @@ bool PN532::readPassiveTargetID(uint8_t cardbaudrate, uint8_t *uid, uint8_t *uid
     return 1;
 }
 
+/**************************************************************************/
+/*!
+    Starts to wait for an ISO14443A target, complete it by
+    pollPassiveTargetID() without blocking
+
+    @param  cardBaudRate  Baud rate of the card
+
+    @returns 1 if the command was sent, 0 for an error
+*/
+/**************************************************************************/
+bool PN532::beginPassiveTargetID(uint8_t cardbaudrate)
+{
+    pn532_packetbuffer[0] = PN532_COMMAND_INLISTPASSIVETARGET;
+    pn532_packetbuffer[1] = 1;  // max 1 cards at once
+    pn532_packetbuffer[2] = cardbaudrate;
+
+    return (0 == beginCommand(pn532_packetbuffer, 3));
+}
+
+/**************************************************************************/
+/*!
+    Checks once for the target of beginPassiveTargetID()
+
+    @param  uid           Pointer to the array that will be populated
+                          with the card's UID (up to 7 bytes)
+    @param  uidLength     Pointer to the variable that will hold the
+                          length of the card's UID.
+
+    @returns 1 if a target was found, PN532_PENDING while waiting,
+             0 for an error or no target
+*/
+/**************************************************************************/
+int8_t PN532::pollPassiveTargetID(uint8_t *uid, uint8_t *uidLength)
+{
+    int16_t status = poll();
+    if (PN532_PENDING == status) {
+        return PN532_PENDING;
+    }
+    if (status < 0 || pn532_packetbuffer[0] != 1) {
+        return 0;
+    }
+
+    // b0 tags found, b1 tag number, b2..3 SENS_RES, b4 SEL_RES, b5 NFCID length, b6.. NFCID
+    return copyTargetID(&pn532_packetbuffer[5], uid, uidLength);
+}
+
+/**************************************************************************/
+/*!
+    Starts autonomous polling for a target, complete it by
+    pollAutoPollTarget() without blocking. The PN532 additionally
+    signals a detected target (or the end of polling) by pulling the
+    IRQ pin low.
+
+    @param  pollNr        Number of polling rounds, 0xFF for endless polling
+    @param  period        Polling period in units of 150 ms (1..15)
+    @param  type          Target type to poll for (e.g. PN532_AUTOPOLL_MIFARE)
+
+    @returns 1 if the command was sent, 0 for an error
+*/
+/**************************************************************************/
+bool PN532::startAutoPoll(uint8_t pollNr, uint8_t period, uint8_t type)
+{
+    pn532_packetbuffer[0] = PN532_COMMAND_INAUTOPOLL;
+    pn532_packetbuffer[1] = pollNr;
+    pn532_packetbuffer[2] = period;
+    pn532_packetbuffer[3] = type;
+
+    DMSG("InAutoPoll\n");
+
+    return (0 == beginCommand(pn532_packetbuffer, 4));
+}
+
+/**************************************************************************/
+/*!
+    Checks once for the target of startAutoPoll()
+
+    @param  uid           Pointer to the array that will be populated
+                          with the card's UID (up to 7 bytes)
+    @param  uidLength     Pointer to the variable that will hold the
+                          length of the card's UID.
+
+    @returns 1 if a target was found, 0 if the polls found no target,
+             PN532_PENDING while polling, another negative value for an error
+*/
+/**************************************************************************/
+int8_t PN532::pollAutoPollTarget(uint8_t *uid, uint8_t *uidLength)
+{
+    int16_t status = poll();
+    if (status < 0) {
+        return status;
+    }
+    if (pn532_packetbuffer[0] < 1) {
+        return 0;
+    }
+
+    /* InAutoPoll response should be in the following format:
+
+      byte            Description
+      -------------   ------------------------------------------
+      b0              Tags Found
+      b1              Type
+      b2              Target Data Length
+      b3              Tag Number
+      b4..5           SENS_RES
+      b6              SEL_RES
+      b7              NFCID Length
+      b8..NFCIDLen    NFCID
+    */
+
+    inListedTag = pn532_packetbuffer[3];
+    return copyTargetID(&pn532_packetbuffer[7], uid, uidLength);
+}
+
+/**************************************************************************/
+/*!
+    Copies the NFCID (length byte followed by the id) of a target response
+*/
+/**************************************************************************/
+bool PN532::copyTargetID(const uint8_t *nfcid, uint8_t *uid, uint8_t *uidLength)
+{
+    uint8_t length = nfcid[0];
+    if (length > sizeof(_uid))
+        length = sizeof(_uid);
+    *uidLength = length;
+
+    for (uint8_t i = 0; i < length; i++) {
+        uid[i] = nfcid[1 + i];
+    }
+
+    return 1;
+}
+
+int8_t PN532::beginCommand(const uint8_t *header, uint8_t hlen)
+{
+    return HAL(beginCommand)(header, hlen);
+}
+
+int16_t PN532::poll()
+{
+    return HAL(pollResponse)(pn532_packetbuffer, sizeof(pn532_packetbuffer));
+}
+
 
 /***** Mifare Classic Functions ******/
 
@@ -679,6 +849,27 @@ uint8_t PN532::mifareclassic_WriteNDEFURI (uint8_t sectorNumber, uint8_t uriIden
 */
 /**************************************************************************/
 uint8_t PN532::mifareultralight_ReadPage (uint8_t page, uint8_t *buffer)
+{
+    uint8_t data[16];
+    if (!mifareultralight_ReadPages(page, data)) {
+        return 0;
+    }
+
+    memcpy (buffer, data, 4);
+    return 1;
+}
+
+/**************************************************************************/
+/*!
+    Tries to read four 4-bytes pages starting at the specified address,
+    the Mifare Read command always returns 16 bytes.
+
+    @param  page        The first page number (0..63 in most cases)
+    @param  buffer      Pointer to the byte array that will hold the
+                        retrieved 16 bytes (if any)
+*/
+/**************************************************************************/
+uint8_t PN532::mifareultralight_ReadPages (uint8_t page, uint8_t *buffer)
 {
     if (page >= 64) {
         DMSG("Page value out of range\n");
@@ -697,21 +888,17 @@ uint8_t PN532::mifareultralight_ReadPage (uint8_t page, uint8_t *buffer)
     }
 
     /* Read the response packet */
-    HAL(readResponse)(pn532_packetbuffer, sizeof(pn532_packetbuffer));
+    if (HAL(readResponse)(pn532_packetbuffer, sizeof(pn532_packetbuffer)) < 17) {
+        return 0;
+    }
 
     /* If byte 8 isn't 0x00 we probably have an error */
-    if (pn532_packetbuffer[0] == 0x00) {
-        /* Copy the 4 data bytes to the output buffer         */
-        /* Block content starts at byte 9 of a valid response */
-        /* Note that the command actually reads 16 bytes or 4  */
-        /* pages at a time ... we simply discard the last 12  */
-        /* bytes                                              */
-        memcpy (buffer, pn532_packetbuffer + 1, 4);
-    } else {
+    if (pn532_packetbuffer[0] != 0x00) {
         return 0;
     }
 
-    // Return OK signal
+    /* Block content starts at byte 9 of a valid response */
+    memcpy (buffer, pn532_packetbuffer + 1, 16);
     return 1;
 }
 
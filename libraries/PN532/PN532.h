@@ -52,6 +52,19 @@
 
 #define PN532_MIFARE_ISO14443A              (0x00)
 
+// InAutoPoll target types
+#define PN532_AUTOPOLL_MIFARE               (0x10)
+#define PN532_AUTOPOLL_ENDLESS              (0xFF)
+
+// PowerDown wake up sources
+#define PN532_WAKEUP_INT0                   (0x01)
+#define PN532_WAKEUP_INT1                   (0x02)
+#define PN532_WAKEUP_RF                     (0x08)
+#define PN532_WAKEUP_HSU                    (0x10)
+#define PN532_WAKEUP_SPI                    (0x20)
+#define PN532_WAKEUP_GPIO                   (0x40)
+#define PN532_WAKEUP_I2C                    (0x80)
+
 // Mifare Commands
 #define MIFARE_CMD_AUTH_A                   (0x60)
 #define MIFARE_CMD_AUTH_B                   (0x61)
@@ -139,6 +152,22 @@ public:
     bool writeGPIO(uint8_t pinstate);
     uint8_t readGPIO(void);
     bool setPassiveActivationRetries(uint8_t maxRetries);
+    bool powerDown(uint8_t wakeupEnable);
+
+    /**
+    * @brief    Split-phase command, the response is completed by poll() from the main loop
+    * @return   0       success
+    *           not 0   failed
+    */
+    int8_t beginCommand(const uint8_t *header, uint8_t hlen);
+
+    /**
+    * @brief    Check once for the response of beginCommand(), never waits
+    * @return   >=0     length of the response (see getBuffer())
+    *           PN532_PENDING   not completed yet
+    *           <0      failed
+    */
+    int16_t poll();
 
     /**
     * @brief    Init PN532 as a target
@@ -158,6 +187,10 @@ public:
     // ISO14443A functions
     bool inListPassiveTarget();
     bool readPassiveTargetID(uint8_t cardbaudrate, uint8_t *uid, uint8_t *uidLength, uint16_t timeout = 1000);
+    bool startAutoPoll(uint8_t pollNr, uint8_t period, uint8_t type);
+    int8_t pollAutoPollTarget(uint8_t *uid, uint8_t *uidLength);
+    bool beginPassiveTargetID(uint8_t cardbaudrate);
+    int8_t pollPassiveTargetID(uint8_t *uid, uint8_t *uidLength);
     bool inDataExchange(uint8_t *send, uint8_t sendLength, uint8_t *response, uint8_t *responseLength);
 
     // Mifare Classic functions
@@ -171,6 +204,7 @@ public:
 
     // Mifare Ultralight functions
     uint8_t mifareultralight_ReadPage (uint8_t page, uint8_t *buffer);
+    uint8_t mifareultralight_ReadPages (uint8_t page, uint8_t *buffer);
     uint8_t mifareultralight_WritePage (uint8_t page, uint8_t *buffer);
 
     // FeliCa Functions
@@ -202,6 +236,8 @@ private:
 
     uint8_t pn532_packetbuffer[255];
 
+    bool copyTargetID(const uint8_t *nfcid, uint8_t *uid, uint8_t *uidLength);
+
     PN532Interface *_interface;
 };
 
@@ -19,6 +19,7 @@
 #define PN532_TIMEOUT                 (-2)
 #define PN532_INVALID_FRAME           (-3)
 #define PN532_NO_SPACE                (-4)
+#define PN532_PENDING                 (-5)  // split-phase command not completed yet
 
 #define REVERSE_BITS_ORDER(b)         b = (b & 0xF0) >> 4 | (b & 0x0F) << 4; \
                                       b = (b & 0xCC) >> 2 | (b & 0x33) << 2; \
@@ -50,6 +51,32 @@ public:
     *           <0      failed to read response
     */
     virtual int16_t readResponse(uint8_t buf[], uint8_t len, uint16_t timeout = 1000) = 0;
+
+    /**
+    * @brief    write a command without waiting for the ack, complete it by pollResponse()
+    * @return   0       success
+    *           not 0   failed
+    */
+    virtual int8_t beginCommand(const uint8_t *header, uint8_t hlen, const uint8_t *body = 0, uint8_t blen = 0) {
+        return writeCommand(header, hlen, body, blen);
+    }
+
+    /**
+    * @brief    check once for the ack and response of beginCommand(), never waits
+    * @param    buf     to contain the response data
+    * @param    len     lenght to read
+    * @return   >=0     length of response without prefix and suffix
+    *           PN532_PENDING   not ready yet, poll again later
+    *           <0      failed to read response
+    */
+    virtual int16_t pollResponse(uint8_t buf[], uint8_t len) {
+        return readResponse(buf, len);
+    }
+
+    /**
+    * @brief    abort the command in progress (e.g. InAutoPoll) by sending an ACK frame
+    */
+    virtual void abortCommand() {}
 };
 
 #endif
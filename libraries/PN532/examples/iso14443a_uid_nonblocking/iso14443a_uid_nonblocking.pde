@@ -0,0 +1,71 @@
+/**************************************************************************/
+/*! 
+    This example waits for an ISO14443A card like iso14443a_uid, but
+    with the split-phase API: the command is started once and its
+    response is polled from the loop, which keeps running while the
+    PN532 is waiting for a card.
+
+    The number of loop passes per second is printed to show that the
+    loop is never blocked.
+
+    To enable debug message, define DEBUG in PN532/PN532_debug.h
+    
+*/
+/**************************************************************************/
+
+#include <Wire.h>
+#include <PN532_I2C.h>
+#include <PN532.h>
+
+PN532_I2C pn532i2c(Wire);
+PN532 nfc(pn532i2c);
+
+unsigned long loops = 0;
+unsigned long lastReport = 0;
+  
+void setup(void) {
+  Serial.begin(115200);
+  Serial.println("Hello!");
+
+  nfc.begin();
+
+  uint32_t versiondata = nfc.getFirmwareVersion();
+  if (! versiondata) {
+    Serial.print("Didn't find PN53x board");
+    while (1); // halt
+  }
+  
+  // Wait forever for a card, the loop is not blocked by it
+  nfc.setPassiveActivationRetries(0xFF);
+  
+  // configure board to read RFID tags
+  nfc.SAMConfig();
+    
+  Serial.println("Waiting for an ISO14443A card");
+  nfc.beginPassiveTargetID(PN532_MIFARE_ISO14443A);
+}
+
+void loop(void) {
+  uint8_t uid[] = { 0, 0, 0, 0, 0, 0, 0 };  // Buffer to store the returned UID
+  uint8_t uidLength;                        // Length of the UID (4 or 7 bytes depending on ISO14443A card type)
+  
+  int8_t status = nfc.pollPassiveTargetID(&uid[0], &uidLength);
+  if (status != PN532_PENDING) {
+    if (status) {
+      Serial.print("UID Value: ");
+      for (uint8_t i=0; i < uidLength; i++) 
+      {
+        Serial.print(" 0x");Serial.print(uid[i], HEX); 
+      }
+      Serial.println("");
+    }
+    nfc.beginPassiveTargetID(PN532_MIFARE_ISO14443A);
+  }
+
+  loops++;
+  if (millis() - lastReport >= 1000) {
+    Serial.print("Loops per second: "); Serial.println(loops);
+    loops = 0;
+    lastReport = millis();
+  }
+}
@@ -4,15 +4,25 @@
 
 #include "PN532_I2C.h"
 #include "PN532_debug.h"
+#include "PN532.h"
 #include "Arduino.h"
 
 #define PN532_I2C_ADDRESS       (0x48 >> 1)
 
+const uint8_t PN532_ACK[] = {0, 0, 0xFF, 0, 0xFF, 0};
+
 
 PN532_I2C::PN532_I2C(TwoWire &wire)
 {
     _wire = &wire;
     command = 0;
+    pending = PN532_I2C_IDLE;
+    _trace = 0;
+}
+
+void PN532_I2C::setTrace(PN532_I2C_Trace trace)
+{
+    _trace = trace;
 }
 
 void PN532_I2C::begin()
@@ -27,6 +37,62 @@ void PN532_I2C::wakeup()
 
 int8_t PN532_I2C::writeCommand(const uint8_t *header, uint8_t hlen, const uint8_t *body, uint8_t blen)
 {
+    int8_t status = writeFrame(header, hlen, body, blen);
+    if (status) {
+        return status;
+    }
+
+    return readAckFrame();
+}
+
+int8_t PN532_I2C::beginCommand(const uint8_t *header, uint8_t hlen, const uint8_t *body, uint8_t blen)
+{
+    int8_t status = writeFrame(header, hlen, body, blen);
+    if (status) {
+        pending = PN532_I2C_IDLE;
+        return status;
+    }
+
+    pending = PN532_I2C_WAIT_ACK;
+    commandTime = millis();
+    return 0;
+}
+
+int16_t PN532_I2C::pollResponse(uint8_t buf[], uint8_t len)
+{
+    if (PN532_I2C_WAIT_ACK == pending) {
+        if (!isReady(sizeof(PN532_ACK) + 1)) {
+            if ((uint16_t)(millis() - commandTime) > PN532_ACK_WAIT_TIME) {
+                DMSG("Time out when waiting for ACK\n");
+                pending = PN532_I2C_IDLE;
+                return PN532_TIMEOUT;
+            }
+            return PN532_PENDING;
+        }
+
+        int8_t status = checkAckFrame();
+        if (status) {
+            pending = PN532_I2C_IDLE;
+            return status;
+        }
+        pending = PN532_I2C_WAIT_RESPONSE;
+    }
+
+    if (PN532_I2C_WAIT_RESPONSE != pending) {
+        return PN532_INVALID_FRAME;     // no command in progress
+    }
+    // only the status while pending, the response may take long (e.g. waiting for a card)
+    if (!isReady(1) || !isReady(responseReadSize())) {
+        return PN532_PENDING;
+    }
+
+    pending = PN532_I2C_IDLE;
+    return receiveFrame(buf, len, PN532_ACK_WAIT_TIME);
+}
+
+int8_t PN532_I2C::writeFrame(const uint8_t *header, uint8_t hlen, const uint8_t *body, uint8_t blen)
+{
+    unsigned long start = micros();
     command = header[0];
     _wire->beginTransmission(PN532_I2C_ADDRESS);
     
@@ -70,30 +136,82 @@ int8_t PN532_I2C::writeCommand(const uint8_t *header, uint8_t hlen, const uint8_
     write(PN532_POSTAMBLE);
     
     _wire->endTransmission();
+    if (_trace) _trace(length + 7, start);
     
     DMSG('\n');
 
-    return readAckFrame();
+    return 0;
 }
 
-int16_t PN532_I2C::getResponseLength(uint8_t buf[], uint8_t len, uint16_t timeout) {
-    const uint8_t PN532_NACK[] = {0, 0, 0xFF, 0xFF, 0, 0};
-    uint16_t time = 0;
+/**
+ * Request count bytes and check the first byte (status) for a ready PN532.
+ */
+bool PN532_I2C::isReady(uint8_t count)
+{
+    unsigned long start = micros();
+    uint8_t received = _wire->requestFrom(PN532_I2C_ADDRESS, count);
+    if (_trace) _trace(received, start);
+    return received && (read() & 1);
+}
 
-    do {
-        if (_wire->requestFrom(PN532_I2C_ADDRESS, 6)) {
-            if (read() & 1) {  // check first byte --- status
-                break;         // PN532 is ready
-            }
-        }
+/**
+ * Bytes to read for the response of the last command, the whole frame when its
+ * size is known and fits into the Wire buffer, otherwise only up to its length.
+ */
+uint8_t PN532_I2C::responseReadSize()
+{
+    uint8_t data;
+    switch (command) {
+        case PN532_COMMAND_GETFIRMWAREVERSION:  data = 4; break;
+        case PN532_COMMAND_SAMCONFIGURATION:    data = 0; break;
+        case PN532_COMMAND_RFCONFIGURATION:     data = 0; break;
+        case PN532_COMMAND_POWERDOWN:           data = 1; break;
+        case PN532_COMMAND_INLISTPASSIVETARGET: data = 13; break;   // one target with 7 byte uid
+        case PN532_COMMAND_INAUTOPOLL:          data = 15; break;   // one target with 7 byte uid
+        case PN532_COMMAND_INDATAEXCHANGE:      data = 17; break;   // status and one 16 byte block
+        default:                                return 6;           // [RDY] 00 00 FF LEN LCS
+    }
+    // [RDY] 00 00 FF LEN LCS TFI CMD (PD0 ... PDn) DCS 00
+    return data + 10;
+}
 
+int16_t PN532_I2C::readResponse(uint8_t buf[], uint8_t len, uint16_t timeout)
+{
+    uint16_t time = 0;
+
+    // only the status until ready, then the response in one request
+    while (!isReady(1) || !isReady(responseReadSize())) {
         delay(1);
         time++;
         if ((0 != timeout) && (time > timeout)) {
             return -1;
         }
-    } while (1); 
-    
+    }
+
+    return receiveFrame(buf, len, timeout);
+}
+
+/**
+ * Read the frame of a ready PN532 from the Wire buffer. When it was not read
+ * completely, request it again with its actual length.
+ */
+int16_t PN532_I2C::receiveFrame(uint8_t buf[], uint8_t len, uint16_t timeout)
+{
+    int16_t length = readLength();
+    if (length < 0) {
+        return length;
+    }
+
+    if (_wire->available() < length + 3) {      // LCS (TFI PD0 ... PDn) DCS 00
+        requestAgain();
+        return readFrame(buf, len, length, timeout);
+    }
+
+    return parseFrame(buf, len, length);
+}
+
+int16_t PN532_I2C::readLength()
+{
     if (0x00 != read()      ||       // PREAMBLE
             0x00 != read()  ||       // STARTCODE1
             0xFF != read()           // STARTCODE2
@@ -102,50 +220,47 @@ int16_t PN532_I2C::getResponseLength(uint8_t buf[], uint8_t len, uint16_t timeou
         return PN532_INVALID_FRAME;
     }
     
-    uint8_t length = read();
+    return read();
+}
+
+/**
+ * Request the last response frame again.
+ */
+void PN532_I2C::requestAgain()
+{
+    const uint8_t PN532_NACK[] = {0, 0, 0xFF, 0xFF, 0, 0};
 
-    // request for last respond msg again
+    unsigned long start = micros();
     _wire->beginTransmission(PN532_I2C_ADDRESS);
     for (uint16_t i = 0; i < sizeof(PN532_NACK); ++i) {
       write(PN532_NACK[i]);
     }
     _wire->endTransmission();
-
-    return length;
+    if (_trace) _trace(sizeof(PN532_NACK), start);
 }
 
-int16_t PN532_I2C::readResponse(uint8_t buf[], uint8_t len, uint16_t timeout)
+int16_t PN532_I2C::readFrame(uint8_t buf[], uint8_t len, uint8_t length, uint16_t timeout)
 {
     uint16_t time = 0;
-    uint8_t length;
-
-    length = getResponseLength(buf, len, timeout);
 
     // [RDY] 00 00 FF LEN LCS (TFI PD0 ... PDn) DCS 00
-    do {
-        if (_wire->requestFrom(PN532_I2C_ADDRESS, 6 + length + 2)) {
-            if (read() & 1) {  // check first byte --- status
-                break;         // PN532 is ready
-            }
-        }
-
+    while (!isReady(6 + length + 2)) {
         delay(1);
         time++;
         if ((0 != timeout) && (time > timeout)) {
             return -1;
         }
-    } while (1); 
-    
-    if (0x00 != read()      ||       // PREAMBLE
-            0x00 != read()  ||       // STARTCODE1
-            0xFF != read()           // STARTCODE2
-        ) {
-        
+    }
+
+    if (readLength() != length) {
         return PN532_INVALID_FRAME;
     }
-    
-    length = read();
 
+    return parseFrame(buf, len, length);
+}
+
+int16_t PN532_I2C::parseFrame(uint8_t buf[], uint8_t len, uint8_t length)
+{
     if (0 != (uint8_t)(length + read())) {   // checksum of length
         return PN532_INVALID_FRAME;
     }
@@ -182,35 +297,44 @@ int16_t PN532_I2C::readResponse(uint8_t buf[], uint8_t len, uint16_t timeout)
     return length;
 }
 
+void PN532_I2C::abortCommand()
+{
+    pending = PN532_I2C_IDLE;
+    unsigned long start = micros();
+    _wire->beginTransmission(PN532_I2C_ADDRESS);
+    for (uint8_t i = 0; i < sizeof(PN532_ACK); i++) {
+        write(PN532_ACK[i]);
+    }
+    _wire->endTransmission();
+    if (_trace) _trace(sizeof(PN532_ACK), start);
+}
+
 int8_t PN532_I2C::readAckFrame()
 {
-    const uint8_t PN532_ACK[] = {0, 0, 0xFF, 0, 0xFF, 0};
-    uint8_t ackBuf[sizeof(PN532_ACK)];
-    
     DMSG("wait for ack at : ");
     DMSG(millis());
     DMSG('\n');
     
     uint16_t time = 0;
-    do {
-        if (_wire->requestFrom(PN532_I2C_ADDRESS,  sizeof(PN532_ACK) + 1)) {
-            if (read() & 1) {  // check first byte --- status
-                break;         // PN532 is ready
-            }
-        }
-
+    while (!isReady(sizeof(PN532_ACK) + 1)) {
         delay(1);
         time++;
         if (time > PN532_ACK_WAIT_TIME) {
             DMSG("Time out when waiting for ACK\n");
             return PN532_TIMEOUT;
         }
-    } while (1); 
+    }
     
     DMSG("ready at : ");
     DMSG(millis());
     DMSG('\n');
     
+    return checkAckFrame();
+}
+
+int8_t PN532_I2C::checkAckFrame()
+{
+    uint8_t ackBuf[sizeof(PN532_ACK)];
 
     for (uint8_t i = 0; i < sizeof(PN532_ACK); i++) {
         ackBuf[i] = read();
@@ -8,6 +8,14 @@
 #include <Wire.h>
 #include "PN532Interface.h"
 
+// Split-phase command state
+#define PN532_I2C_IDLE              0
+#define PN532_I2C_WAIT_ACK          1
+#define PN532_I2C_WAIT_RESPONSE     2
+
+// Optional trace of each bus transaction: bytes transferred, start micros()
+typedef void (*PN532_I2C_Trace)(uint8_t bytes, unsigned long start);
+
 class PN532_I2C : public PN532Interface {
 public:
     PN532_I2C(TwoWire &wire);
@@ -16,13 +24,28 @@ public:
     void wakeup();
     virtual int8_t writeCommand(const uint8_t *header, uint8_t hlen, const uint8_t *body = 0, uint8_t blen = 0);
     int16_t readResponse(uint8_t buf[], uint8_t len, uint16_t timeout);
+    int8_t beginCommand(const uint8_t *header, uint8_t hlen, const uint8_t *body = 0, uint8_t blen = 0);
+    int16_t pollResponse(uint8_t buf[], uint8_t len);
+    void abortCommand();
+    void setTrace(PN532_I2C_Trace trace);
     
 private:
     TwoWire* _wire;
     uint8_t command;
+    uint8_t pending;
+    uint16_t commandTime;
+    PN532_I2C_Trace _trace;
     
+    int8_t writeFrame(const uint8_t *header, uint8_t hlen, const uint8_t *body, uint8_t blen);
+    bool isReady(uint8_t count);
     int8_t readAckFrame();
-    int16_t getResponseLength(uint8_t buf[], uint8_t len, uint16_t timeout);
+    int8_t checkAckFrame();
+    uint8_t responseReadSize();
+    int16_t receiveFrame(uint8_t buf[], uint8_t len, uint16_t timeout);
+    int16_t readLength();
+    void requestAgain();
+    int16_t readFrame(uint8_t buf[], uint8_t len, uint8_t length, uint16_t timeout);
+    int16_t parseFrame(uint8_t buf[], uint8_t len, uint8_t length);
     
     inline uint8_t write(uint8_t data) {
         #if ARDUINO >= 100
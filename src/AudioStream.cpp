@@ -0,0 +1,210 @@
+/*
+ * Class to stream a track from the SD card to the VS1053 decoder through a double buffer.
+ * The main loop fills free buffers from the card, the DREQ interrupt sends buffered
+ * data to the decoder. When both buffers ran empty (main loop busy) the interrupt
+ * refills them from the card itself, unless the main loop holds the card (lockCard).
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include "AudioStream.h"
+
+
+AudioStream::AudioStream(Adafruit_VS1053& codec)
+: codec(codec) {}
+
+/*
+ * Start streaming the (opened and positioned) track, both buffers are filled before
+ * the interrupt starts to feed.
+ */
+void AudioStream::start(File& track) {
+  stop();
+  this->track = track;
+  fillIndex = 0;
+  feedIndex = 0;
+  position = 0;
+  eof = false;
+  starving = false;
+  chained = false;
+  bytesFed = 0;
+  underruns = 0;
+  refills = 0;
+  calls = 0;
+  startMillis = millis();
+  fill();
+  paused = false;
+  playing = true;
+}
+
+/*
+ * Continue with the next track when the current one is read completely.
+ * Too late when the current track has already ended.
+ */
+bool AudioStream::chain(File& next) {
+  if (eof || this->next) return false;
+  this->next = next;
+  return true;
+}
+
+void AudioStream::pause(bool pause) {
+  paused = pause;
+}
+
+void AudioStream::stop() {
+  playing = false;
+  eof = true;
+  lengths[0] = 0;
+  lengths[1] = 0;
+  track.close();
+  next.close();
+}
+
+/*
+ * Read from the SD card into the free buffers (main loop).
+ */
+void AudioStream::fill() {
+  lockCard();
+  while (!eof && lengths[fillIndex] == 0 && readBuffer());
+  unlockCard();
+  kick();
+}
+
+/*
+ * The main loop accesses the card (e.g. opens the next track), the interrupt must
+ * not refill the buffers meanwhile. Calls may be nested.
+ */
+void AudioStream::lockCard() {
+  cardLocks++;
+}
+
+void AudioStream::unlockCard() {
+  cardLocks--;
+}
+
+/*
+ * Read the next part of the track (or the chained one) into the free buffer,
+ * called with the card held.
+ */
+bool AudioStream::readBuffer() {
+  if (track.available() == 0 && next) {
+    track.close();
+    track = next;
+    next = File();
+    chained = true;
+  }
+  int length = track.read(buffers[fillIndex], STREAM_BUFFER_SIZE);
+  if (length <= 0) {
+    track.close();
+    eof = true;
+    return false;
+  }
+  lengths[fillIndex] = length;
+  fillIndex ^= 1;
+  return true;
+}
+
+/*
+ * The pin change interrupt only fires when DREQ changes, feed from the main loop
+ * when the decoder is still requesting data (start, resume, underrun).
+ */
+void AudioStream::kick() {
+  if (!playing || paused || !codec.readyForData()) return;
+  noInterrupts();
+  feed();
+  interrupts();
+}
+
+/*
+ * Send buffered data to the decoder as long as it requests data (interrupt).
+ * Both buffers are empty when the next one is, it is refilled from the card unless
+ * the main loop holds it. An empty buffer while the decoder requests data is
+ * counted as underrun.
+ */
+void AudioStream::feed() {
+  calls++;
+  if (!playing || paused) return;
+
+  while (codec.readyForData()) {
+    byte length = lengths[feedIndex];
+    if (length == 0 && !eof && cardLocks == 0) {
+      cardLocks++;
+      readBuffer();
+      cardLocks--;
+      refills++;
+      length = lengths[feedIndex];
+    }
+    if (length == 0) {
+      if (!eof && !starving) {
+        starving = true;
+        underruns++;
+      }
+      return;
+    }
+    starving = false;
+
+    byte chunk = min(length - position, VS1053_DATABUFFERLEN);
+    if (bytesFed == 0) firstFeedMicros = micros();
+    codec.playData(buffers[feedIndex] + position, chunk);
+    position += chunk;
+    bytesFed += chunk;
+    if (position >= length) {
+      position = 0;
+      lengths[feedIndex] = 0;
+      feedIndex ^= 1;
+    }
+  }
+}
+
+bool AudioStream::hasEnded() {
+  return !playing || (eof && lengths[0] == 0 && lengths[1] == 0);
+}
+
+/*
+ * True once after the stream switched to the chained track.
+ */
+bool AudioStream::hasChained() {
+  noInterrupts();
+  bool result = chained;
+  chained = false;
+  interrupts();
+  return result;
+}
+
+/*
+ * Bytes of the current track not yet read from the card (max. 32767).
+ */
+uint16_t AudioStream::remaining() {
+  lockCard();
+  uint16_t bytes = eof ? 0 : track.available();
+  unlockCard();
+  return bytes;
+}
+
+/*
+ * Time of the first data sent to the decoder since start(), false if none yet.
+ */
+bool AudioStream::getFirstFeed(unsigned long& time) {
+  noInterrupts();
+  bool fed = bytesFed > 0;
+  time = firstFeedMicros;
+  interrupts();
+  return fed;
+}
+
+void AudioStream::printStatistics() {
+  noInterrupts();
+  uint32_t bytes = bytesFed;
+  uint16_t count = underruns;
+  uint16_t interruptRefills = refills;
+  uint32_t feeds = calls;
+  interrupts();
+  unsigned long duration = millis() - startMillis;
+
+  Serial.print(F("Stream ")); Serial.print(bytes);
+  Serial.print(F(" bytes, ")); Serial.print(duration == 0 ? 0 : bytes / duration);
+  Serial.print(F(" kB/s, ")); Serial.print(duration == 0 ? 0 : feeds * 1000 / duration);
+  Serial.print(F(" feeds/s, refills ")); Serial.print(interruptRefills);
+  Serial.print(F(", underruns ")); Serial.println(count);
+}
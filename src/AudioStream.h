@@ -0,0 +1,69 @@
+/*
+ * Class to stream a track from the SD card to the VS1053 decoder through a double buffer.
+ * The main loop fills free buffers from the card, the DREQ interrupt sends buffered
+ * data to the decoder. When both buffers ran empty (main loop busy) the interrupt
+ * refills them from the card itself, unless the main loop holds the card (lockCard).
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef AudioStream_h
+#define AudioStream_h
+
+#include <Arduino.h>
+#include <SD.h>
+#include <Adafruit_VS1053.h>
+
+// Size of each of the two buffers [bytes], max. 255
+#define STREAM_BUFFER_SIZE   128
+
+
+class AudioStream {
+  public:
+    AudioStream(Adafruit_VS1053& codec);
+
+    void start(File& track);
+    bool chain(File& next);
+    void pause(bool pause);
+    void stop();
+
+    void fill();
+    void feed();
+    void lockCard();
+    void unlockCard();
+
+    bool hasEnded();
+    bool hasChained();
+    uint16_t remaining();
+    bool getFirstFeed(unsigned long& time);
+    void printStatistics();
+
+  private:
+    Adafruit_VS1053& codec;
+    File track;
+    File next;
+    byte buffers[2][STREAM_BUFFER_SIZE];
+    volatile byte lengths[2] = { 0, 0 };   // 0 = free to fill
+    volatile byte fillIndex = 0;            // whoever holds the card
+    byte feedIndex = 0;                     // interrupt only
+    byte position = 0;                      // interrupt only
+    volatile bool playing = false;
+    volatile bool paused = false;
+    volatile bool eof = true;
+    volatile bool starving = false;
+    volatile bool chained = false;
+    volatile byte cardLocks = 0;            // main loop reads the card
+
+    bool readBuffer();
+    void kick();
+
+    volatile uint32_t bytesFed = 0;
+    volatile unsigned long firstFeedMicros = 0;
+    volatile uint16_t underruns = 0;
+    volatile uint16_t refills = 0;          // by the interrupt
+    volatile uint32_t calls = 0;
+    unsigned long startMillis = 0;
+};
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * Class to trace the transactions on the shared I2C bus (nfc reader, trellis).
+ * The last transactions are kept in a ring buffer and printed as histogram of
+ * their duration per device when 'b' is received over serial.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include "BusTrace.h"
+
+BusTrace busTrace = BusTrace();
+
+
+/*
+ * Record a transaction of the device that started at the given micros().
+ */
+void BusTrace::record(byte device, byte bytes, unsigned long start) {
+#ifdef BUS_TRACE
+  unsigned long duration = micros() - start;
+  BusEvent& event = events[next];
+  event.device = device;
+  event.bytes = bytes;
+  event.micros = min(duration, 0xFFFFUL);
+  next = (next + 1) % BUS_TRACE_SIZE;
+  if (count < BUS_TRACE_SIZE) count++;
+#endif
+}
+
+void BusTrace::print() {
+#ifdef BUS_TRACE
+  for (byte device = 0; device < BUS_DEVICES; device++) {
+    uint16_t transactions = 0;
+    uint16_t bytes = 0;
+    unsigned long duration = 0;
+    uint16_t histogram[BUS_BUCKETS] = { 0 };
+    for (byte i = 0; i < count; i++) {
+      if (events[i].device != device) continue;
+      transactions++;
+      bytes += events[i].bytes;
+      duration += events[i].micros;
+      histogram[bucket(events[i].micros)]++;
+    }
+
+    Serial.print(F("Bus ")); Serial.print(device == BUS_NFC ? F("nfc") : F("trellis"));
+    Serial.print(F(": ")); Serial.print(transactions);
+    Serial.print(F(" transactions, ")); Serial.print(bytes);
+    Serial.print(F(" bytes, ")); Serial.print(duration); Serial.println(F(" us"));
+    for (byte b = 0; b < BUS_BUCKETS; b++) {
+      if (b < BUS_BUCKETS - 1) {
+        Serial.print(F("  <")); Serial.print(128U << b);
+      } else {
+        Serial.print(F("  >=")); Serial.print(128U << (b - 1));
+      }
+      Serial.print(F("us ")); Serial.println(histogram[b]);
+    }
+  }
+  clear();
+#endif
+}
+
+void BusTrace::clear() {
+#ifdef BUS_TRACE
+  next = 0;
+  count = 0;
+#endif
+}
+
+/*
+ * Histogram bucket of a duration, doubling from 128us (last bucket open-ended).
+ */
+byte BusTrace::bucket(uint16_t micros) {
+  byte bucket = 0;
+  for (uint16_t limit = 128; micros >= limit && bucket < BUS_BUCKETS - 1; limit <<= 1) {
+    bucket++;
+  }
+  return bucket;
+}
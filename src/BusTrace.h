@@ -0,0 +1,53 @@
+/*
+ * Class to trace the transactions on the shared I2C bus (nfc reader, trellis).
+ * The last transactions are kept in a ring buffer and printed as histogram of
+ * their duration per device when 'b' is received over serial.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef BusTrace_h
+#define BusTrace_h
+
+#include <Arduino.h>
+
+// Trace I2C transactions (uncomment to enable, uses 128 bytes RAM)
+//#define BUS_TRACE
+
+// Devices
+#define BUS_NFC          0
+#define BUS_TRELLIS      1
+#define BUS_DEVICES      2
+
+// Trace setup
+#define BUS_TRACE_SIZE  32    // transactions kept
+#define BUS_BUCKETS      6    // duration <128us, <256us, .. <2ms, >=2ms
+
+
+struct BusEvent {
+  byte device;
+  byte bytes;
+  uint16_t micros;
+};
+
+
+class BusTrace {
+  public:
+    void record(byte device, byte bytes, unsigned long start);
+    void print();
+    void clear();
+
+  private:
+#ifdef BUS_TRACE
+    BusEvent events[BUS_TRACE_SIZE];
+    byte next = 0;
+    byte count = 0;
+#endif
+
+    static byte bucket(uint16_t micros);
+};
+
+extern BusTrace busTrace;
+
+#endif
@@ -0,0 +1,352 @@
+/*
+ * Class to look up the value of a configuration key (button index, nfc id) using
+ * a sorted binary index file next to the text configuration on the SD card.
+ *
+ * The index is rebuilt at startup whenever the configuration changed (size or checksum).
+ * Lookups use a binary search on the index and read the value directly from its
+ * offset in the text configuration. Without an index, or for a key added since it
+ * was built, the text file is scanned.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include "ConfigIndex.h"
+#include "FileSort.h"
+
+#define entryPosition(start, i)   ((start) + (uint32_t)(i) * INDEX_ENTRY_SIZE)
+
+
+ConfigIndex::ConfigIndex(const char* cfgName, const char* indexName)
+: cfgName(cfgName), indexName(indexName) {}
+
+void ConfigIndex::initialize() {
+  File cfg = SD.open(cfgName);
+  if (!cfg) return;
+  uint16_t cfgChecksum = checksum(cfg);
+  if (!isCurrent(cfg.size(), cfgChecksum)) {
+    rebuild(cfg, cfgChecksum);
+  }
+  cfg.close();
+}
+
+bool ConfigIndex::isCurrent(uint32_t cfgSize, uint16_t cfgChecksum) {
+  File index = SD.open(indexName);
+  if (!index) return false;
+  IndexHeader header;
+  bool current = readHeader(index, header) && header.cfgSize == cfgSize && header.cfgChecksum == cfgChecksum;
+  index.close();
+  return current;
+}
+
+/*
+ * CRC-16 (CCITT) of the text configuration, an edit of the same size changes it.
+ */
+uint16_t ConfigIndex::checksum(File& cfg) {
+  uint16_t crc = 0xFFFF;
+  byte buffer[32];
+  int length;
+  cfg.seek(0);
+  while ((length = cfg.read(buffer, sizeof(buffer))) > 0) {
+    for (int i = 0; i < length; i++) {
+      crc ^= (uint16_t)buffer[i] << 8;
+      for (byte bit = 0; bit < 8; bit++) {
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+      }
+    }
+  }
+  return crc;
+}
+
+bool ConfigIndex::readHeader(File& index, IndexHeader& header) {
+  return index.read((byte*)&header, sizeof(header)) == sizeof(header)
+      && memcmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) == 0;
+}
+
+/*
+ * Index file layout:
+ *   header (16 bytes)
+ *   fences: first key of each entry sector (16 bytes each)
+ *   entries: sorted by key, starting on a sector boundary (16 bytes each)
+ * The header is written last, an interrupted build leaves an invalid index.
+ */
+void ConfigIndex::rebuild(File& cfg, uint16_t cfgChecksum) {
+  Serial.print(F("Build index ")); Serial.println(indexName);
+  uint16_t count = parseEntries(cfg, NULL, 0);
+  uint16_t sectors = (count + INDEX_ENTRIES_PER_SECTOR - 1) / INDEX_ENTRIES_PER_SECTOR;
+  uint32_t dataStart = entryPosition(sizeof(IndexHeader), sectors);
+  dataStart = (dataStart + INDEX_SECTOR_SIZE - 1) / INDEX_SECTOR_SIZE * INDEX_SECTOR_SIZE;
+
+  SD.remove(indexName);
+  File index = SD.open(indexName, O_READ | O_WRITE | O_CREAT);
+  if (!index) {
+    Serial.println(F("Index failed"));
+    return;
+  }
+  for (uint32_t i = 0; i < dataStart; i++) {
+    index.write((byte)0);
+  }
+
+  parseEntries(cfg, &index, dataStart);
+  FileSort::sort(index, dataStart, count, compareRecords);
+
+  IndexEntry entry;
+  for (uint16_t s = 0; s < sectors; s++) {
+    readEntry(index, entryPosition(dataStart, s * INDEX_ENTRIES_PER_SECTOR), entry);
+    writeEntry(index, entryPosition(sizeof(IndexHeader), s), entry);
+  }
+
+  IndexHeader header;
+  memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+  header.cfgSize = cfg.size();
+  header.cfgChecksum = cfgChecksum;
+  header.count = count;
+  header.sectors = sectors;
+  header.dataStart = dataStart;
+  index.seek(0);
+  index.write((const byte*)&header, sizeof(header));
+  index.close();
+  Serial.print(count); Serial.println(F(" entries indexed"));
+}
+
+/*
+ * Parse all 'key=value' lines and write an (unsorted) entry per hex key, a sector
+ * of entries at once. Comments and keys that are not hex numbers are skipped.
+ */
+uint16_t ConfigIndex::parseEntries(File& cfg, File* index, uint32_t dataStart) {
+  uint16_t count = 0;
+  IndexEntry entries[INDEX_ENTRIES_PER_SECTOR];
+  char key[2 * (INDEX_KEY_SIZE - 1)];
+  byte keyLength = 0;
+  bool skipLine = false;
+
+  cfg.seek(0);
+  while (cfg.available()) {
+    char c = cfg.read();
+    if (c == '\n' || c == '\r') {
+      keyLength = 0;
+      skipLine = false;
+    } else if (skipLine || c == ' ' || c == '\t') {
+      // nop
+    } else if (c == '=') {
+      IndexEntry& entry = entries[count % INDEX_ENTRIES_PER_SECTOR];
+      if (count < 0xFFFF && packKey(key, keyLength, entry.key)) {
+        entry.offset = cfg.position();
+        count++;
+        if (index && count % INDEX_ENTRIES_PER_SECTOR == 0) {
+          writeEntries(*index, entryPosition(dataStart, count - INDEX_ENTRIES_PER_SECTOR), entries, INDEX_ENTRIES_PER_SECTOR);
+        }
+      }
+      skipLine = true;
+    } else if (keyLength < sizeof(key)) {
+      key[keyLength++] = c;
+    } else {
+      skipLine = true;
+    }
+  }
+  byte rest = count % INDEX_ENTRIES_PER_SECTOR;
+  if (index && rest > 0) {
+    writeEntries(*index, entryPosition(dataStart, count - rest), entries, rest);
+  }
+  return count;
+}
+
+/*
+ * Copy the value of the key into the buffer, empty if not configured.
+ * Of several lines with the key the first non-empty value is used.
+ * The offset of the value is returned, -1 if the key is not in the configuration.
+ */
+bool ConfigIndex::lookup(const char* key, char* value, byte size, long* offset) {
+  long found = -1;
+  bool configured = false;
+  IndexEntry target;
+  File index;
+  IndexHeader header;
+  if (packKey(key, strlen(key), target.key)) {
+    index = SD.open(indexName);
+  }
+  if (index && readHeader(index, header)) {
+    target.offset = 0;
+    IndexEntry entry;
+    long i = findEntry(index, header, target, entry);
+    while (i >= 0) {
+      configured = readValue(entry.offset, value, size);
+      if (configured || found < 0) found = entry.offset;
+      if (configured || ++i >= header.count) break;
+      readEntry(index, entryPosition(header.dataStart, i), entry);
+      if (memcmp(entry.key, target.key, INDEX_KEY_SIZE) != 0) break;
+    }
+  }
+  index.close();
+  if (found < 0) {
+    configured = scanConfig(key, value, size, found);
+  }
+  if (!configured) value[0] = '\0';
+  if (offset) *offset = found;
+  return configured;
+}
+
+/*
+ * Find the first entry of the given key: a binary search on the fences selects
+ * the entry sector, a second binary search within that (cached) sector the entry.
+ * Returns the number of the entry (read into entry), -1 if the key is not indexed.
+ */
+long ConfigIndex::findEntry(File& index, const IndexHeader& header, const IndexEntry& target, IndexEntry& entry) {
+  uint16_t low = 1;
+  uint16_t high = header.sectors;
+  while (low < high) {
+    uint16_t mid = (low + high) / 2;
+    readEntry(index, entryPosition(sizeof(IndexHeader), mid), entry);
+    if (compare(entry, target) < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  low = (low - 1) * INDEX_ENTRIES_PER_SECTOR;
+  high = low + INDEX_ENTRIES_PER_SECTOR;
+  if (high > header.count) high = header.count;
+  while (low < high) {
+    uint16_t mid = (low + high) / 2;
+    readEntry(index, entryPosition(header.dataStart, mid), entry);
+    if (compare(entry, target) < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  if (low >= header.count) return -1;
+
+  readEntry(index, entryPosition(header.dataStart, low), entry);
+  if (memcmp(entry.key, target.key, INDEX_KEY_SIZE) != 0) return -1;
+  return low;
+}
+
+/*
+ * Read the value at the offset up to the end of its line, without leading and trailing blanks.
+ * A longer value than fits into the buffer is truncated and reported.
+ */
+bool ConfigIndex::readValue(uint32_t offset, char* value, byte size) {
+  byte length = 0;
+  File cfg = SD.open(cfgName);
+  if (cfg && cfg.seek(offset)) {
+    while (cfg.available() && length < size - 1) {
+      char c = cfg.read();
+      if (c == '\n' || c == '\r') break;
+      if (length == 0 && (c == ' ' || c == '\t')) continue;
+      value[length++] = c;
+    }
+    if (length == size - 1) {
+      while (cfg.available()) {
+        char c = cfg.read();
+        if (c == '\n' || c == '\r') break;
+        if (!isspace(c)) {
+          printTooLong(size);
+          break;
+        }
+      }
+    }
+  }
+  cfg.close();
+  while (length > 0 && isspace(value[length - 1])) {
+    length--;
+  }
+  value[length] = '\0';
+  return length != 0;
+}
+
+/*
+ * Fallback without index, or for a key added since the index was built: scan all
+ * 'key=value' lines (keys ignoring case) for the first non-empty value of the key.
+ */
+bool ConfigIndex::scanConfig(const char* key, char* value, byte size, long& found) {
+  bool configured = false;
+  byte length = strlen(key);
+  char name[2 * (INDEX_KEY_SIZE - 1)];
+  byte nameLength = 0;
+  bool skipLine = false;
+
+  File cfg = SD.open(cfgName);
+  while (cfg && !configured && cfg.available()) {
+    char c = cfg.read();
+    if (c == '\n' || c == '\r') {
+      nameLength = 0;
+      skipLine = false;
+    } else if (skipLine || c == ' ' || c == '\t') {
+      // nop
+    } else if (c == '=') {
+      if (nameLength == length && strncasecmp(name, key, length) == 0) {
+        long offset = cfg.position();
+        configured = readValue(offset, value, size);
+        if (configured || found < 0) found = offset;
+      }
+      skipLine = true;
+    } else if (nameLength < sizeof(name)) {
+      name[nameLength++] = c;
+    } else {
+      skipLine = true;
+    }
+  }
+  cfg.close();
+  return configured;
+}
+
+void ConfigIndex::printTooLong(byte size) {
+  Serial.print(F("Value truncated in ")); Serial.print(cfgName);
+  Serial.print(F(", max. length ")); Serial.println(size - 1);
+}
+
+/*
+ * Pack a hex key into a length byte followed by its nibbles, e.g. "04C8F" -> 05 04 C8 F0 00..
+ */
+bool ConfigIndex::packKey(const char* key, byte length, byte* packed) {
+  if (length == 0 || length > 2 * (INDEX_KEY_SIZE - 1)) return false;
+  memset(packed, 0, INDEX_KEY_SIZE);
+  packed[0] = length;
+  for (byte i = 0; i < length; i++) {
+    char c = key[i];
+    byte nibble;
+    if (c >= '0' && c <= '9') {
+      nibble = c - '0';
+    } else if (c >= 'A' && c <= 'F') {
+      nibble = c - 'A' + 10;
+    } else if (c >= 'a' && c <= 'f') {
+      nibble = c - 'a' + 10;
+    } else {
+      return false;
+    }
+    packed[1 + i / 2] |= (i % 2 == 0) ? nibble << 4 : nibble;
+  }
+  return true;
+}
+
+/*
+ * Order by key, equal keys by their position in the text configuration.
+ */
+int ConfigIndex::compare(const IndexEntry& a, const IndexEntry& b) {
+  int result = memcmp(a.key, b.key, INDEX_KEY_SIZE);
+  if (result != 0) return result;
+  if (a.offset == b.offset) return 0;
+  return a.offset < b.offset ? -1 : 1;
+}
+
+int ConfigIndex::compareRecords(const byte* a, const byte* b) {
+  return compare(*(const IndexEntry*)a, *(const IndexEntry*)b);
+}
+
+void ConfigIndex::readEntry(File& index, uint32_t position, IndexEntry& entry) {
+  index.seek(position);
+  index.read((byte*)&entry, sizeof(entry));
+}
+
+void ConfigIndex::writeEntry(File& index, uint32_t position, const IndexEntry& entry) {
+  index.seek(position);
+  index.write((const byte*)&entry, sizeof(entry));
+}
+
+void ConfigIndex::writeEntries(File& index, uint32_t position, const IndexEntry* entries, byte count) {
+  index.seek(position);
+  index.write((const byte*)entries, count * sizeof(IndexEntry));
+}
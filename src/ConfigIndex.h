@@ -0,0 +1,77 @@
+/*
+ * Class to look up the value of a configuration key (button index, nfc id) using
+ * a sorted binary index file next to the text configuration on the SD card.
+ *
+ * The index is rebuilt at startup whenever the configuration changed (size or checksum).
+ * Lookups use a binary search on the index and read the value directly from its
+ * offset in the text configuration. Without an index, or for a key added since it
+ * was built, the text file is scanned.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef ConfigIndex_h
+#define ConfigIndex_h
+
+#include <Arduino.h>
+#include <SD.h>
+
+// Index file layout
+#define INDEX_MAGIC           "MBI2"
+#define INDEX_SECTOR_SIZE     512
+#define INDEX_KEY_SIZE        12    // length byte + up to 22 hex digits
+#define INDEX_ENTRY_SIZE      16
+#define INDEX_ENTRIES_PER_SECTOR   (INDEX_SECTOR_SIZE / INDEX_ENTRY_SIZE)
+
+// Maximum length of a configured value (path), incl. terminating zero.
+// Longer values are truncated (reported on Serial), see extras/config/*.cfg
+#define CONFIG_VALUE_LENGTH   64
+
+
+struct IndexHeader {
+  char magic[4];
+  uint32_t cfgSize;       // size of the text configuration when the index was built
+  uint16_t cfgChecksum;   // and its CRC-16
+  uint16_t count;         // number of entries
+  uint16_t sectors;       // number of entry sectors (= number of fences)
+  uint16_t dataStart;     // file offset of the first entry, sector aligned
+};
+
+struct IndexEntry {
+  byte key[INDEX_KEY_SIZE];
+  uint32_t offset;        // file offset of the value in the text configuration
+};
+
+
+class ConfigIndex {
+  public:
+    ConfigIndex(const char* cfgName, const char* indexName);
+    void initialize();
+
+    bool lookup(const char* key, char* value, byte size, long* offset = 0);
+    bool readValue(uint32_t offset, char* value, byte size);
+
+  private:
+    const char* cfgName;
+    const char* indexName;
+
+    bool isCurrent(uint32_t cfgSize, uint16_t cfgChecksum);
+    static uint16_t checksum(File& cfg);
+    static bool readHeader(File& index, IndexHeader& header);
+    void rebuild(File& cfg, uint16_t cfgChecksum);
+    uint16_t parseEntries(File& cfg, File* index, uint32_t dataStart);
+
+    long findEntry(File& index, const IndexHeader& header, const IndexEntry& target, IndexEntry& entry);
+    bool scanConfig(const char* key, char* value, byte size, long& found);
+    void printTooLong(byte size);
+
+    static bool packKey(const char* key, byte length, byte* packed);
+    static int compare(const IndexEntry& a, const IndexEntry& b);
+    static int compareRecords(const byte* a, const byte* b);
+    static void readEntry(File& index, uint32_t position, IndexEntry& entry);
+    static void writeEntry(File& index, uint32_t position, const IndexEntry& entry);
+    static void writeEntries(File& index, uint32_t position, const IndexEntry* entries, byte count);
+};
+
+#endif
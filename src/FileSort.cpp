@@ -0,0 +1,115 @@
+/*
+ * Merge sort of fixed size records in a file on the SD card, in a few sequential
+ * passes: runs of a sector are sorted in RAM, then pairs of runs are merged into
+ * the area behind the records and back (the file grows by the size of the records).
+ * Uses a buffer of a sector on the stack, the file must be opened for read/write.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include "FileSort.h"
+
+#define recordPosition(start, i)   ((start) + (uint32_t)(i) * SORT_RECORD_SIZE)
+
+
+void FileSort::sort(File& file, uint32_t start, uint16_t count, RecordCompare compare) {
+  byte buffer[SORT_BUFFER_SIZE];
+  for (uint16_t i = 0; i < count; i += SORT_RUN_RECORDS) {
+    byte records = min((uint16_t)(count - i), (uint16_t)SORT_RUN_RECORDS);
+    file.seek(recordPosition(start, i));
+    file.read(buffer, records * SORT_RECORD_SIZE);
+    sortRun(buffer, records, compare);
+    file.seek(recordPosition(start, i));
+    file.write(buffer, records * SORT_RECORD_SIZE);
+  }
+
+  uint32_t from = start;
+  uint32_t to = recordPosition(start, count);
+  for (uint32_t run = SORT_RUN_RECORDS; run < count; run *= 2) {
+    for (uint32_t low = 0; low < count; low += 2 * run) {
+      uint16_t mid = min(low + run, (uint32_t)count);
+      uint16_t high = min(low + 2 * run, (uint32_t)count);
+      merge(file, from, to, low, mid, high, buffer, compare);
+    }
+    uint32_t merged = to;
+    to = from;
+    from = merged;
+  }
+  if (from != start) {
+    copy(file, from, start, count, buffer);
+  }
+}
+
+/*
+ * Insertion sort of a run in RAM.
+ */
+void FileSort::sortRun(byte* records, byte count, RecordCompare compare) {
+  byte record[SORT_RECORD_SIZE];
+  for (byte i = 1; i < count; i++) {
+    memcpy(record, records + i * SORT_RECORD_SIZE, SORT_RECORD_SIZE);
+    byte j = i;
+    while (j > 0 && compare(records + (j - 1) * SORT_RECORD_SIZE, record) > 0) {
+      memcpy(records + j * SORT_RECORD_SIZE, records + (j - 1) * SORT_RECORD_SIZE, SORT_RECORD_SIZE);
+      j--;
+    }
+    memcpy(records + j * SORT_RECORD_SIZE, record, SORT_RECORD_SIZE);
+  }
+}
+
+/*
+ * Merge the sorted runs [low, mid) and [mid, high) at 'from' into [low, high) at 'to'.
+ * The buffer holds a few records of each run and the merged records before they are written.
+ */
+void FileSort::merge(File& file, uint32_t from, uint32_t to, uint16_t low, uint16_t mid, uint16_t high,
+                     byte* buffer, RecordCompare compare) {
+  SortInput a = { recordPosition(from, low), recordPosition(from, mid), buffer, 0, 0 };
+  SortInput b = { recordPosition(from, mid), recordPosition(from, high), buffer + SORT_INPUT_RECORDS * SORT_RECORD_SIZE, 0, 0 };
+  byte* output = buffer + 2 * SORT_INPUT_RECORDS * SORT_RECORD_SIZE;
+  byte merged = 0;
+  uint32_t position = recordPosition(to, low);
+  while (true) {
+    bool moreA = fill(file, a);
+    bool moreB = fill(file, b);
+    if (moreA || moreB) {
+      SortInput& next = (!moreB || (moreA && compare(a.buffer + a.next * SORT_RECORD_SIZE,
+                                                      b.buffer + b.next * SORT_RECORD_SIZE) <= 0)) ? a : b;
+      memcpy(output + merged * SORT_RECORD_SIZE, next.buffer + next.next * SORT_RECORD_SIZE, SORT_RECORD_SIZE);
+      next.next++;
+      merged++;
+    }
+    if (merged == SORT_OUTPUT_RECORDS || (merged > 0 && !moreA && !moreB)) {
+      file.seek(position);
+      file.write(output, merged * SORT_RECORD_SIZE);
+      position += merged * SORT_RECORD_SIZE;
+      merged = 0;
+    }
+    if (!moreA && !moreB) break;
+  }
+}
+
+/*
+ * Refill the buffer of a run when all its records are merged.
+ * Returns false at the end of the run.
+ */
+bool FileSort::fill(File& file, SortInput& input) {
+  if (input.next < input.count) return true;
+  if (input.position >= input.end) return false;
+  input.count = min(input.end - input.position, (uint32_t)SORT_INPUT_RECORDS * SORT_RECORD_SIZE) / SORT_RECORD_SIZE;
+  input.next = 0;
+  file.seek(input.position);
+  file.read(input.buffer, input.count * SORT_RECORD_SIZE);
+  input.position += input.count * SORT_RECORD_SIZE;
+  return true;
+}
+
+void FileSort::copy(File& file, uint32_t from, uint32_t to, uint16_t count, byte* buffer) {
+  for (uint16_t i = 0; i < count; i += SORT_RUN_RECORDS) {
+    uint16_t length = min((uint16_t)(count - i), (uint16_t)SORT_RUN_RECORDS) * SORT_RECORD_SIZE;
+    file.seek(recordPosition(from, i));
+    file.read(buffer, length);
+    file.seek(recordPosition(to, i));
+    file.write(buffer, length);
+  }
+}
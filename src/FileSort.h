@@ -0,0 +1,47 @@
+/*
+ * Merge sort of fixed size records in a file on the SD card, in a few sequential
+ * passes: runs of a sector are sorted in RAM, then pairs of runs are merged into
+ * the area behind the records and back (the file grows by the size of the records).
+ * Uses a buffer of a sector on the stack, the file must be opened for read/write.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef FileSort_h
+#define FileSort_h
+
+#include <Arduino.h>
+#include <SD.h>
+
+#define SORT_RECORD_SIZE    16
+#define SORT_BUFFER_SIZE    512   // one sector
+#define SORT_RUN_RECORDS    (SORT_BUFFER_SIZE / SORT_RECORD_SIZE)
+#define SORT_INPUT_RECORDS  (SORT_RUN_RECORDS / 4)    // buffered of each run to merge
+#define SORT_OUTPUT_RECORDS (SORT_RUN_RECORDS / 2)    // buffered merged records
+
+
+typedef int (*RecordCompare)(const byte* a, const byte* b);
+
+struct SortInput {
+  uint32_t position;      // next record to read into the buffer
+  uint32_t end;           // behind the last record of the run
+  byte* buffer;
+  byte count;             // records in the buffer
+  byte next;              // next record in the buffer
+};
+
+
+class FileSort {
+  public:
+    static void sort(File& file, uint32_t start, uint16_t count, RecordCompare compare);
+
+  private:
+    static void sortRun(byte* records, byte count, RecordCompare compare);
+    static void merge(File& file, uint32_t from, uint32_t to, uint16_t low, uint16_t mid, uint16_t high,
+                      byte* buffer, RecordCompare compare);
+    static bool fill(File& file, SortInput& input);
+    static void copy(File& file, uint32_t from, uint32_t to, uint16_t count, byte* buffer);
+};
+
+#endif
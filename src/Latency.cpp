@@ -0,0 +1,40 @@
+/*
+ * Class to measure the latency from a user action (key, nfc tag, track end) until
+ * the first data of the track was sent to the decoder (see AudioStream::getFirstFeed()).
+ * Measurements are printed as csv lines 'latency,<event>,<micros>' over serial.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include "Latency.h"
+
+
+void Latency::start(const __FlashStringHelper* event) {
+#ifdef LATENCY_CSV
+  this->event = event;
+  startMicros = micros();
+#endif
+}
+
+/*
+ * Print the time from start until the first feed of the track, a feed of a track
+ * started before is ignored.
+ */
+void Latency::stop(unsigned long firstFeed) {
+#ifdef LATENCY_CSV
+  if (!event || (int32_t)(firstFeed - startMicros) < 0) return;
+  unsigned long duration = firstFeed - startMicros;
+  Serial.print(F("latency,")); Serial.print(event);
+  Serial.print(','); Serial.println(duration);
+  event = NULL;
+#endif
+}
+
+/*
+ * No track started for the event.
+ */
+void Latency::cancel() {
+  event = NULL;
+}
@@ -0,0 +1,30 @@
+/*
+ * Class to measure the latency from a user action (key, nfc tag, track end) until
+ * the first data of the track was sent to the decoder (see AudioStream::getFirstFeed()).
+ * Measurements are printed as csv lines 'latency,<event>,<micros>' over serial.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef Latency_h
+#define Latency_h
+
+#include <Arduino.h>
+
+// Print latencies over serial (uncomment to enable)
+//#define LATENCY_CSV
+
+
+class Latency {
+  public:
+    void start(const __FlashStringHelper* event);
+    void stop(unsigned long firstFeed);
+    void cancel();
+
+  private:
+    const __FlashStringHelper* event = NULL;
+    unsigned long startMicros;
+};
+
+#endif
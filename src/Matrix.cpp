@@ -1,5 +1,11 @@
 /*
- * Class to drive a trellis display matrix.
+ * Class to drive a trellis display matrix of one or more boards (TRELLIS_BOARDS),
+ * key n is key n % 16 of the board at address TRELLIS_ADDRESS + n / 16.
+ * LEDs are only changed in the frame buffers of the boards, flush() writes the
+ * bytes that differ from the display RAM of each HT16K33 (once per loop pass).
+ * Keys are only read when a HT16K33 signals key data on the shared INT line, and
+ * polled while keys are held to see them released. Only the boards having key
+ * data or held keys are read.
  * 
  * Written by Jörg Keller, Winterthur, Switzerland
  * https://github.com/joergkeller/arduino-musicbox
@@ -7,79 +13,250 @@
  */
 
 #include "Matrix.h"
+#include <Wire.h>
+
+// HT16K33 command to read the key interrupt flag
+#define HT16K33_INT_FLAG   0x60
+
+volatile bool Matrix::keySignaled = false;
 
 Matrix::Matrix() {
   // INT pin requires a pullup;
   // this is also the MIDI Tx pin recommended to bound to high
   pinMode(TRELLIS_INT_PIN, INPUT_PULLUP);
+  memset(keys, 0, sizeof(keys));
+  show.select(SHOW_DEFAULT);
 }
 
 void Matrix::initialize() {
-  // clear display
-  trellis.begin(0x70);
-  trellis.clear();
-  trellis.writeDisplay();
+  for (byte b = 0; b < TRELLIS_BOARDS; b++) {
+    // clear display
+    boards[b].begin(TRELLIS_ADDRESS + b);
+    boards[b].clear();
+    boards[b].writeDisplay();
 
-  // ignore already pressed switches
-  trellis.readSwitches(); 
+    // ignore already pressed switches
+    boards[b].readSwitches(); 
+  }
+  memset(shown, 0, sizeof(shown));
+  attachKeyInterrupt();
 }
 
-void Matrix::tickMs() {
-  if (isIdle) {
-    show.tickMs();
-  }
+/*
+ * Run the idle show, returns the milliseconds until its next frame (-1 = none).
+ */
+long Matrix::animate(unsigned long now) {
+  return isIdle ? show.run(now) : -1;
+}
+
+void Matrix::selectShow(const char* name) {
+  show.select(name);
 }
 
 void Matrix::idle() {
   isIdle = true;
-  show.initialize();
+  // the show sets brightness and blink rate by itself
+  shownBrightness = 0xFF;
+  shownBlinkRate = 0xFF;
+  show.initialize(millis());
 }
 
+/*
+ * Blink the LED of the key. Brightness and blink rate are written at once, so is the
+ * frame (not left to the next flush) to change all three together.
+ */
 void Matrix::blink(byte index, bool fast) {
   isIdle = false;
-  trellis.clear();
-  trellis.setBrightness(BRIGHTNESS_PLAYING);
-  trellis.setLED(index);
-  trellis.blinkRate(fast ? HT16K33_BLINK_1HZ : HT16K33_BLINK_HALFHZ);
-  trellis.writeDisplay();
+  for (byte b = 0; b < TRELLIS_BOARDS; b++) {
+    boards[b].clear();
+  }
+  if (index < NUMKEYS) {
+    boards[index / TRELLIS_KEYS].setLED(index % TRELLIS_KEYS);
+  }
+  flush();
+  setBrightness(BRIGHTNESS_PLAYING);
+  setBlinkRate(fast ? HT16K33_BLINK_1HZ : HT16K33_BLINK_HALFHZ);
+}
+
+void Matrix::setBrightness(byte brightness) {
+  if (brightness != shownBrightness) {
+    for (byte b = 0; b < TRELLIS_BOARDS; b++) {
+      boards[b].setBrightness(brightness);
+    }
+    shownBrightness = brightness;
+  }
+}
+
+void Matrix::setBlinkRate(byte rate) {
+  if (rate != shownBlinkRate) {
+    for (byte b = 0; b < TRELLIS_BOARDS; b++) {
+      boards[b].blinkRate(rate);
+    }
+    shownBlinkRate = rate;
+  }
+}
+
+void Matrix::flush() {
+  for (byte b = 0; b < TRELLIS_BOARDS; b++) {
+    flush(b);
+  }
+}
+
+/*
+ * Write the changed bytes of the frame buffer in one transfer, from the first to the
+ * last changed display RAM address. The rows are little endian on the AVR, the same
+ * byte order as in the display RAM. Unchanged boards are not written.
+ */
+void Matrix::flush(byte board) {
+  const byte* frame = (const byte*)boards[board].displaybuffer;
+  const byte* held = (const byte*)shown[board];
+  int8_t first = -1;
+  byte last = 0;
+  for (byte i = 0; i < TRELLIS_RAM_SIZE; i++) {
+    if (frame[i] != held[i]) {
+      if (first < 0) first = i;
+      last = i;
+    }
+  }
+  if (first < 0) return;
+
+#ifdef BUS_TRACE
+  unsigned long start = micros();
+#endif
+  Wire.beginTransmission(TRELLIS_ADDRESS + board);
+  Wire.write((byte)first);   // display RAM address
+  for (byte i = first; i <= last; i++) {
+    Wire.write(frame[i]);
+  }
+  Wire.endTransmission();
+#ifdef BUS_TRACE
+  busTrace.record(BUS_TRELLIS, last - first + 2, start);
+#endif
+  memcpy(shown[board], frame, sizeof(shown[board]));
 }
 
 void Matrix::waitForNoKeyPressed() {
   unsigned long timeout = millis() + 1000;
   while (millis() <= timeout) { 
     byte keyPressed = 0;
-    trellis.readSwitches();
-    for (byte i = 0; i < NUMKEYS; i++) {
-      keyPressed += trellis.isKeyPressed(i) ? 1 : 0;
+    for (byte b = 0; b < TRELLIS_BOARDS; b++) {
+      boards[b].readSwitches();
+      for (byte i = 0; i < TRELLIS_KEYS; i++) {
+        keyPressed += boards[b].isKeyPressed(i) ? 1 : 0;
+      }
     }
-    if (keyPressed == 0) return;
+    if (keyPressed == 0) break;
     delay(50);
   }
+  memset(keys, 0, sizeof(keys));
+  eventCount = 0;
+  keySignaled = false;
+}
+
+/*
+ * Next pressed key, -1 if none. The trellis is only read when it signaled key data
+ * or to see held keys released, there is no I2C traffic while nothing is touched.
+ */
+int Matrix::getPressedKey(unsigned long now) {
+  if (keySignaled || (isKeyHeld() && now - lastRead >= KEY_RELEASE_DELAY)) {
+    keySignaled = false;
+    readKeys(now);
+  }
+  if (eventCount == 0) return -1;
+
+  byte key = events[eventStart];
+  eventStart = (eventStart + 1) % KEY_EVENTS;
+  eventCount--;
+  return key;
 }
 
-int Matrix::getPressedKey() {
-  if (trellis.readSwitches()) {
-    for (byte i = 0; i < NUMKEYS; i++) {
-      if (trellis.justPressed(i)) {
-        return i;
+/*
+ * Read the keys of the boards with key data or held keys (clears the INT line) and
+ * queue the newly pressed ones. The keys are debounced by the HT16K33, a key is
+ * pressed after two equal key scans.
+ */
+void Matrix::readKeys(unsigned long now) {
+  lastRead = now;
+  for (byte b = 0; b < TRELLIS_BOARDS; b++) {
+    if (!keys[b] && !hasKeyData(b)) continue;
+
+    boards[b].readSwitches();
+    uint16_t pressed = 0;
+    for (byte i = 0; i < TRELLIS_KEYS; i++) {
+      if (boards[b].isKeyPressed(i)) pressed |= bit(i);
+    }
+
+    uint16_t down = pressed & ~keys[b];
+    for (byte i = 0; i < TRELLIS_KEYS && down; i++) {
+      if ((down & bit(i)) && eventCount < KEY_EVENTS) {
+        events[(eventStart + eventCount) % KEY_EVENTS] = b * TRELLIS_KEYS + i;
+        eventCount++;
       }
+      down &= ~bit(i);
     }
+    keys[b] = pressed;
+  }
+}
+
+/*
+ * The board has unread key data, only asked when several boards share the INT line
+ * (a single byte instead of the 6 bytes of key data).
+ */
+bool Matrix::hasKeyData(byte board) {
+  if (TRELLIS_BOARDS == 1) return true;
+
+#ifdef BUS_TRACE
+  unsigned long start = micros();
+#endif
+  Wire.beginTransmission(TRELLIS_ADDRESS + board);
+  Wire.write(HT16K33_INT_FLAG);
+  Wire.endTransmission();
+  Wire.requestFrom((uint8_t)(TRELLIS_ADDRESS + board), (uint8_t)1);
+  bool flag = Wire.read() != 0;
+#ifdef BUS_TRACE
+  busTrace.record(BUS_TRELLIS, 3, start);
+#endif
+  return flag;
+}
+
+bool Matrix::isKeyHeld() {
+  for (byte b = 0; b < TRELLIS_BOARDS; b++) {
+    if (keys[b]) return true;
   }
-  return -1;
+  return false;
+}
+
+void Matrix::onKeyInterrupt() {
+  keySignaled = true;
+}
+
+void Matrix::attachKeyInterrupt() {
+  attachInterrupt(digitalPinToInterrupt(TRELLIS_INT_PIN), onKeyInterrupt, FALLING);
 }
 
 void Matrix::sleep() {
   isIdle = false;
-  trellis.clear();
-  trellis.writeDisplay();
-  trellis.sleep();
+  memset(keys, 0, sizeof(keys));   // no release polling while sleeping
+  for (byte b = 0; b < TRELLIS_BOARDS; b++) {
+    boards[b].clear();
+  }
+  flush();
+  for (byte b = 0; b < TRELLIS_BOARDS; b++) {
+    boards[b].sleep();
+  }
 }
 
 void Matrix::wakeup() {
   isIdle = false;
-  trellis.wakeup();
+  for (byte b = 0; b < TRELLIS_BOARDS; b++) {
+    boards[b].wakeup();
+  }
+  attachKeyInterrupt();
 }
 
+/*
+ * Wake up from power down by a key, replaces the key interrupt until wakeup().
+ */
 void Matrix::enableInterrupt(void (*isr)(void)) {
   attachInterrupt(digitalPinToInterrupt(TRELLIS_INT_PIN), isr, LOW);
 }
@@ -1,5 +1,11 @@
 /*
- * Class to drive a trellis display matrix.
+ * Class to drive a trellis display matrix of one or more boards (TRELLIS_BOARDS),
+ * key n is key n % 16 of the board at address TRELLIS_ADDRESS + n / 16.
+ * LEDs are only changed in the frame buffers of the boards, flush() writes the
+ * bytes that differ from the display RAM of each HT16K33 (once per loop pass).
+ * Keys are only read when a HT16K33 signals key data on the shared INT line, and
+ * polled while keys are held to see them released. Only the boards having key
+ * data or held keys are read.
  * 
  * Written by Jörg Keller, Winterthur, Switzerland
  * https://github.com/joergkeller/arduino-musicbox
@@ -9,34 +15,38 @@
 #define Matrix_h
 
 #include <Arduino.h>
-#include <Adafruit_Trellis.h>
-#include "ShowAbstract.h"
-#include "ShowAlwaysOn.h"
-#include "ShowRunning.h"
-#include "ShowPulsing.h"
-#include "ShowAlternating.h"
+#include "TracedTrellis.h"
+#include "Show.h"
 
-// Define the idle mode (ShowAlwaysOn, ShowRunning, ShowPulsing, ShowAlternating)
-#define SHOW_CLASS   ShowPulsing
+// Idle show unless selected in settings.cfg (see Show.h)
+#define SHOW_DEFAULT   SHOW_PULSING
 
 // Trellis LED brightness 1..15
 #define BRIGHTNESS_PLAYING   15
 
 // Trellis setup
 #define TRELLIS_INT_PIN    1
+#define TRELLIS_ADDRESS    0x70  // of the first board
+#define TRELLIS_RAM_SIZE   16    // display RAM bytes, 8 rows of 16 bit
+
+// Keys
+#define KEY_RELEASE_DELAY  50    // poll for release while keys are held [ms]
+#define KEY_EVENTS          4    // queued key presses
 
 
 class Matrix {
   public:
     Matrix();
     void initialize();
-    void tickMs();
+    long animate(unsigned long now);
 
+    void selectShow(const char* name);
     void idle();
     void blink(byte index, bool fast);
+    void flush();
 
     void waitForNoKeyPressed();
-    int getPressedKey();
+    int getPressedKey(unsigned long now);
 
     void sleep();
     void wakeup();
@@ -44,9 +54,28 @@ class Matrix {
     void disableInterrupt();
 
   private:
-    const Adafruit_Trellis trellis = Adafruit_Trellis();
-    const SHOW_CLASS show = SHOW_CLASS(trellis);
+    Trellis boards[TRELLIS_BOARDS];
+    Show show = Show(boards);
     bool isIdle = false;
+    uint16_t shown[TRELLIS_BOARDS][TRELLIS_RAM_SIZE / 2];   // display RAM as written to the HT16K33
+    byte shownBrightness;
+    byte shownBlinkRate;
+
+    uint16_t keys[TRELLIS_BOARDS];   // bit per key, set = pressed at the last read
+    unsigned long lastRead;
+    byte events[KEY_EVENTS];  // ring of pressed keys
+    byte eventStart = 0;
+    byte eventCount = 0;
+    static volatile bool keySignaled;
+
+    void setBrightness(byte brightness);
+    void setBlinkRate(byte rate);
+    void flush(byte board);
+    void readKeys(unsigned long now);
+    bool hasKeyData(byte board);
+    bool isKeyHeld();
+    void attachKeyInterrupt();
+    static void onKeyInterrupt();
 };
 
 #endif
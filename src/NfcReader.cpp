@@ -0,0 +1,154 @@
+/*
+ * Class to read nfc cards with a PN532 over I2C.
+ * The PN532 polls for cards by itself and signals a found card on its irq pin,
+ * commands are completed from the main loop without waiting for the PN532.
+ * When disabled it is put into power down mode (wake up by I2C), the firmware
+ * configuration is kept and not repeated when enabled again.
+ * An ignored card (e.g. unknown) is not reported again until it left the field,
+ * the PN532 polls a few times only and reports when no card was found.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include "NfcReader.h"
+#include <NfcAdapter.h>
+
+
+NfcReader::NfcReader() {
+#ifdef BUS_TRACE
+  pn532i2c.setTrace(trace);
+#endif
+}
+
+void NfcReader::trace(uint8_t bytes, unsigned long start) {
+  busTrace.record(BUS_NFC, bytes, start);
+}
+
+/*
+ * Power up and configure the PN532 (once).
+ */
+void NfcReader::initialize() {
+  pinMode(NFC_RESET_PIN, OUTPUT);
+  digitalWrite(NFC_RESET_PIN, HIGH);
+  pinMode(NFC_IRQ_PIN, INPUT_PULLUP);
+  nfc.begin();
+  uint32_t versiondata = nfc.getFirmwareVersion();
+  if (!versiondata) {
+    Serial.println(F("PN532 failed"));
+    powerState = NFC_MISSING;
+    return;
+  }
+
+  nfc.SAMConfig();
+  Serial.println(F("PN532 initialized"));
+  startPolling();
+}
+
+void NfcReader::enable(bool enable) {
+  if (enable) {
+    if (powerState == NFC_UNKNOWN) {
+      initialize();
+    } else if (powerState == NFC_POWER_DOWN) {
+      Serial.println(F("Enable NFC"));
+      // any command wakes up the PN532, the first one may be lost while waking up
+      if (nfc.getFirmwareVersion() || nfc.getFirmwareVersion()) {
+        startPolling();
+      }
+    }
+  } else if (powerState == NFC_POLLING) {
+    Serial.println(F("Disable NFC"));
+    if (nfc.powerDown(PN532_WAKEUP_I2C)) {
+      powerState = NFC_POWER_DOWN;
+    }
+  }
+}
+
+/*
+ * The PN532 has an ack or a found card ready (irq pin low), read it with readCard().
+ */
+bool NfcReader::hasCard() {
+  return powerState == NFC_POLLING && digitalRead(NFC_IRQ_PIN) == LOW;
+}
+
+/*
+ * Read the card found by polling without blocking. Polling is restarted when it
+ * failed or found the ignored card, after a card was found it is restarted by
+ * startPolling().
+ */
+bool NfcReader::readCard(TagId& id) {
+  int8_t result = nfc.pollAutoPollTarget(id.uid, &id.length);
+  if (result == PN532_PENDING) return false; // still polling
+  if (result == 0) {
+    ignoredId.length = 0; // no card found, the ignored card has left
+  }
+  if (result != 1 || id == ignoredId) {
+    startPolling();
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Do not report the card again until it has left the field.
+ */
+void NfcReader::ignore(const TagId& id) {
+  ignoredId = id;
+}
+
+/*
+ * Read the path of a track or album written on the (still selected) card,
+ * the first text or uri record (without prefix or file://) holding a path.
+ * The records are parsed in place, nothing is allocated on the heap.
+ */
+bool NfcReader::readPath(const TagId& id, char* path, byte size) {
+  byte message[NFC_MESSAGE_SIZE];
+  NfcAdapter adapter = NfcAdapter(nfc);
+  int length = adapter.readMessage(id.uid, id.length, message, sizeof(message));
+  if (length <= 0) return false;
+
+  NdefMessageView view = NdefMessageView(message, length);
+  NdefRecordView record;
+  while (view.next(record)) {
+    if (recordPath(record, path, size)) return true;
+  }
+  return false;
+}
+
+bool NfcReader::recordPath(const NdefRecordView& record, char* path, byte size) {
+  unsigned int length = record.getPayloadLength();
+  if (record.getTnf() != TNF_WELL_KNOWN || record.getTypeLength() != 1 || length < 1) {
+    return false;
+  }
+
+  byte type = record.getType()[0];
+  const byte* payload = record.getPayload();
+  unsigned int start;
+  if (type == 'T') {
+    start = 1 + (payload[0] & 0x3F);  // status byte and language code
+  } else if (type == 'U' && (payload[0] == NDEF_URIPREFIX_NONE || payload[0] == NDEF_URIPREFIX_FILE)) {
+    start = 1;  // uri prefix code
+  } else {
+    return false;
+  }
+
+  byte n = 0;
+  for (unsigned int i = start; i < length && n < size - 1; i++) {
+    path[n++] = payload[i];
+  }
+  path[n] = '\0';
+  return n > 0;
+}
+
+void NfcReader::startPolling() {
+  if (powerState == NFC_MISSING) return;
+
+  // a few polls only while a card is ignored to notice when it has left
+  byte polls = ignoredId.length > 0 ? NFC_ABSENCE_POLLS : PN532_AUTOPOLL_ENDLESS;
+  if (nfc.startAutoPoll(polls, NFC_POLL_PERIOD, PN532_AUTOPOLL_MIFARE)) {
+    powerState = NFC_POLLING;
+  } else {
+    Serial.println(F("PN532 polling failed"));
+  }
+}
@@ -0,0 +1,64 @@
+/*
+ * Class to read nfc cards with a PN532 over I2C.
+ * The PN532 polls for cards by itself and signals a found card on its irq pin,
+ * commands are completed from the main loop without waiting for the PN532.
+ * When disabled it is put into power down mode (wake up by I2C), the firmware
+ * configuration is kept and not repeated when enabled again.
+ * An ignored card (e.g. unknown) is not reported again until it left the field,
+ * the PN532 polls a few times only and reports when no card was found.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef NfcReader_h
+#define NfcReader_h
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <PN532_I2C.h>
+#include <PN532.h>
+#include "TagId.h"
+#include "BusTrace.h"
+
+class NdefRecordView;
+
+// NFC pin setup
+#define NFC_RESET_PIN   13    // PN532 reset pin
+#define NFC_IRQ_PIN      4    // PN532 irq pin, low when a response is ready
+
+// NFC reader
+#define NFC_POLL_PERIOD   1    // autonomous polling period [150ms]
+#define NFC_ABSENCE_POLLS 2    // polls without a card until an ignored card has left
+#define NFC_MESSAGE_SIZE 96    // read buffer of the ndef message (multiple of 16)
+
+// Power states
+#define NFC_UNKNOWN       0    // not initialized yet
+#define NFC_MISSING       1    // no PN532 found, not retried
+#define NFC_POWER_DOWN    2
+#define NFC_POLLING       3
+
+
+class NfcReader {
+  public:
+    NfcReader();
+    void initialize();
+    void enable(bool enable);
+
+    bool hasCard();
+    bool readCard(TagId& id);
+    void ignore(const TagId& id);
+    bool readPath(const TagId& id, char* path, byte size);
+    void startPolling();
+
+  private:
+    PN532_I2C pn532i2c = PN532_I2C(Wire);
+    PN532 nfc = PN532(pn532i2c);
+    byte powerState = NFC_UNKNOWN;
+    TagId ignoredId = { 0 };
+
+    static void trace(uint8_t bytes, unsigned long start);
+    static bool recordPath(const NdefRecordView& record, char* path, byte size);
+};
+
+#endif
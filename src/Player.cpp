@@ -66,9 +66,13 @@ void Player::initializePlayer() {
   player.softReset();
   //player.sineTest(0x44, 500);    // Make a tone to indicate VS1053 is working
 
-  // Timer interrupts are not suggested, better to use DREQ interrupt!
-  // but we don't have them on the 32u4 feather...
-  player.useInterrupt(VS1053_FILEPLAYER_TIMER0_INT); // timer int
+  // DREQ is no external interrupt on the 32u4 feather, the stream is fed from the
+  // pin change interrupt instead (see ISR in src.ino)
+  *digitalPinToPCMSK(MUSIC_DREQ_PIN) |= bit(digitalPinToPCMSKbit(MUSIC_DREQ_PIN));
+  PCIFR = bit(digitalPinToPCICRbit(MUSIC_DREQ_PIN));
+  PCICR |= bit(digitalPinToPCICRbit(MUSIC_DREQ_PIN));
+  // SPI transactions of the card must not be interrupted by it
+  SPI.usingInterrupt(255);
   Serial.println(F("VS1053 initialized"));
 
   enablePlayer(false);
@@ -143,29 +147,115 @@ void Player::onHeadphoneInserted(bool plugged) {
 }
 
 bool Player::startPlaying(const char* path) {
+  stream.stop();    // the card is read by the main loop only
   albumPath = path;
-  album = SD.open(path);
-  if (album.isDirectory()) {
-    return nextTrack(); // first track of album
+  File entry = SD.open(path);
+  bool isAlbum = entry.isDirectory();
+  entry.close();
+  if (isAlbum) {
+    trackIndex = -1;
+    return tracks.open(path) && nextTrack(); // first track of album
   } else {
-    album.close();
-    return player.startPlayingFile(path);
+    tracks.close();
+    return startPlayingFile(path);
   }
 }
 
 bool Player::nextTrack() {
-  if (!album || !album.isDirectory()) return false;
-  File track = album.openNextFile();
+  return playTrack(trackIndex + 1);
+}
+
+bool Player::previousTrack() {
+  return trackIndex > 0 && playTrack(trackIndex - 1);
+}
+
+/*
+ * Start the track with the given index of the album (e.g. to resume).
+ */
+bool Player::playTrack(uint16_t index) {
+  stream.stop();    // the card is read by the main loop only
+  String filePath = trackPath(index);
+  if (filePath.length() == 0) return false;
+
+  Serial.print(F("Track ")); Serial.print(index); Serial.print(F(": ")); Serial.println(filePath);
+  if (!startPlayingFile(filePath.c_str())) {
+    tracks.invalidate(); // outdated list, rebuilt when the album is started again
+    return false;
+  }
+  trackIndex = index;
+  return true;
+}
+
+int Player::getTrackIndex() {
+  return trackIndex;
+}
+
+/*
+ * Reset the decoder and start streaming the file.
+ */
+bool Player::startPlayingFile(const char* path) {
+  stream.stop();
+  prefetched = false;
+  File track = SD.open(path);
   if (!track) return false;
+  if (player.isMP3File(path)) {
+    track.seek(player.mp3_ID3Jumper(track));
+  }
+
+  // reset playback and resync
+  player.sciWrite(VS1053_REG_MODE, VS1053_MODE_SM_LINE1 | VS1053_MODE_SM_SDINEW | VS1053_MODE_SM_LAYER12);
+  player.sciWrite(VS1053_REG_WRAMADDR, 0x1e29);
+  player.sciWrite(VS1053_REG_WRAM, 0);
+  // set decode time back to 0, twice as explained in the datasheet
+  player.sciWrite(VS1053_REG_DECODETIME, 0x00);
+  player.sciWrite(VS1053_REG_DECODETIME, 0x00);
+
+  stream.start(track);
+  return true;
+}
+
+/*
+ * Open the next track of the album while the current one is in its last buffers
+ * and chain it to the stream. Only mp3 streams can be concatenated, the current and
+ * the next track must both be mp3.
+ */
+void Player::prefetchTrack() {
+  if (prefetched || stream.hasEnded() || stream.remaining() >= PREFETCH_BYTES) return;
+  prefetched = true;
 
-  String filePath = extendPath(albumPath, track.name());
-  Serial.print(F("Next track: ")); Serial.println(filePath);
-  track.close();
+  stream.lockCard();
+  nextTrackPath = trackPath(trackIndex + 1);
+  if (nextTrackPath.length() > 0 && player.isMP3File(nextTrackPath.c_str())
+      && player.isMP3File(trackPath(trackIndex).c_str())) {
+    File next = SD.open(nextTrackPath.c_str());
+    if (next) {
+      next.seek(player.mp3_ID3Jumper(next));
+      if (!stream.chain(next)) {
+        next.close();
+      }
+    }
+  }
+  stream.unlockCard();
+}
 
-  player.startPlayingFile(filePath.c_str());
+/*
+ * Check if the stream continued with the prefetched track, without reset and resync
+ * of the decoder.
+ */
+bool Player::continueTrack() {
+  if (!stream.hasChained()) return false;
+  trackIndex++;
+  prefetched = false;
+  Serial.print(F("Continue track: ")); Serial.println(nextTrackPath);
   return true;
 }
 
+String Player::trackPath(uint16_t index) {
+  char name[TRACK_NAME_LENGTH + 1];
+  if (!tracks.getName(index, name)) return String();
+  return extendPath(albumPath, name);
+}
+
 String Player::extendPath(String path, String fileName) {
   if (path.charAt(path.length() - 1) == '/') {
     return path + fileName;
@@ -175,15 +265,41 @@ String Player::extendPath(String path, String fileName) {
 }
 
 void Player::pause(bool pause) {
-  player.pausePlaying(pause);
+  stream.pause(pause);
   enableAmplifier(!pause && !headphone);
 }
 
 void Player::stop() {
-  player.stopPlaying();
+  stream.stop();
+  player.sciWrite(VS1053_REG_MODE, VS1053_MODE_SM_LINE1 | VS1053_MODE_SM_SDINEW | VS1053_MODE_SM_CANCEL);
   delay(20);
 }
 
 bool Player::hasStopped() {
-  return player.stopped();
+  return stream.hasEnded();
+}
+
+/*
+ * Read the card into the stream buffers, to be called from the main loop.
+ */
+void Player::fill() {
+  stream.fill();
+}
+
+/*
+ * Send the stream buffers to the decoder, to be called from the DREQ interrupt.
+ */
+void Player::feed() {
+  stream.feed();
+}
+
+/*
+ * Time when the current track was first fed to the decoder, false if not yet.
+ */
+bool Player::getFirstFeed(unsigned long& time) {
+  return stream.getFirstFeed(time);
+}
+
+void Player::printStatistics() {
+  stream.printStatistics();
 }
@@ -12,13 +12,16 @@
 #include <Arduino.h>
 #include <Adafruit_VS1053.h>
 #include <SD.h>
+#include <SPI.h>
+#include "TrackList.h"
+#include "AudioStream.h"
 
 // Feather/Wing pin setup
 #define MUSIC_RESET_PIN   12     // VS1053 reset pin
 #define CARD_CS_PIN        5     // Card chip select pin
 #define MUSIC_CS_PIN       6     // VS1053 chip select pin (output)
 #define MUSIC_DCS_PIN     10     // VS1053 Data/command select pin (output)
-#define MUSIC_DREQ_PIN     9     // VS1053 Data request, ideally an Interrupt pin (not possible on 32u4)
+#define MUSIC_DREQ_PIN     9     // VS1053 Data request, pin change interrupt (no external interrupt on 32u4)
 
 // Amplifier pin setup
 #define AMPLIFIER_ENABLE_PIN   11   // Enable both amplifier channels
@@ -33,6 +36,9 @@
 #define HEADPHONE_VOLUME_MAX        15    // min. 0 moderation
 #define VOLUME_OFF                 255    // 255 = switch audio off, TODO avoiding cracking noise, maybe correct stuffing needed when stop
 
+// Gapless playback: open the next track when less than this is left to read [bytes]
+#define PREFETCH_BYTES            8192
+
 
 class Player {
 	
@@ -46,15 +52,29 @@ class Player {
 
     bool startPlaying(const char* path);
     bool nextTrack();
+    bool previousTrack();
+    bool playTrack(uint16_t index);
+    int getTrackIndex();
+    void prefetchTrack();
+    bool continueTrack();
     void pause(bool pause);
     void stop();
     bool hasStopped();
+
+    void fill();
+    void feed();
+    bool getFirstFeed(unsigned long& time);
+    void printStatistics();
 	
   private:
     Adafruit_VS1053_FilePlayer player = Adafruit_VS1053_FilePlayer(MUSIC_RESET_PIN, MUSIC_CS_PIN, MUSIC_DCS_PIN, MUSIC_DREQ_PIN, CARD_CS_PIN);
+    AudioStream stream = AudioStream(player);
 
     String albumPath = String();
-    File album;
+    TrackList tracks;
+    int trackIndex = -1;
+    String nextTrackPath = String();
+    bool prefetched = false;
     int volume = VOLUME_INITIAL;
     bool headphone = false;
     bool headphoneFirstMeasure = false;
@@ -66,6 +86,8 @@ class Player {
     void enablePlayer(bool enable);
     void enableAmplifier(bool enable);
     void onHeadphoneInserted(bool plugged);
+    bool startPlayingFile(const char* path);
+    String trackPath(uint16_t index);
     String extendPath(String path, String fileName);
 };
 
@@ -0,0 +1,68 @@
+/*
+ * Class to run tasks at a given time (millis).
+ * Deadlines are compared by their signed 32 bit distance to now (millis() is 32 bit
+ * on the AVR, also where long is wider) and therefore are safe across the rollover
+ * of millis() after ~49 days. A task runs once per schedule,
+ * periodic tasks schedule themselves again.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include "Scheduler.h"
+
+
+Scheduler::Scheduler() {
+  for (byte i = 0; i < SCHEDULER_TASKS; i++) {
+    functions[i] = NULL;
+    deadlines[i] = 0L;
+  }
+}
+
+void Scheduler::define(byte task, TaskFunction function) {
+  functions[task] = function;
+}
+
+void Scheduler::at(byte task, unsigned long time) {
+  deadlines[task] = time;
+  scheduled |= bit(task);
+}
+
+void Scheduler::after(byte task, unsigned long delay) {
+  at(task, millis() + delay);
+}
+
+void Scheduler::cancel(byte task) {
+  scheduled &= ~bit(task);
+}
+
+bool Scheduler::isScheduled(byte task) {
+  return scheduled & bit(task);
+}
+
+/*
+ * Run all due tasks in the order of their number.
+ */
+void Scheduler::run(unsigned long now) {
+  for (byte i = 0; i < SCHEDULER_TASKS; i++) {
+    if (isScheduled(i) && (int32_t)(now - deadlines[i]) >= 0) {
+      cancel(i);
+      if (functions[i]) functions[i](now);
+    }
+  }
+}
+
+/*
+ * Milliseconds until the next task is due (0 = due now), -1 if nothing is scheduled.
+ */
+long Scheduler::untilNext(unsigned long now) {
+  long next = -1;
+  for (byte i = 0; i < SCHEDULER_TASKS; i++) {
+    if (isScheduled(i)) {
+      long remaining = max((int32_t)0, (int32_t)(deadlines[i] - now));
+      if (next < 0 || remaining < next) next = remaining;
+    }
+  }
+  return next;
+}
@@ -0,0 +1,43 @@
+/*
+ * Class to run tasks at a given time (millis).
+ * Deadlines are compared by their signed 32 bit distance to now (millis() is 32 bit
+ * on the AVR, also where long is wider) and therefore are safe across the rollover
+ * of millis() after ~49 days. A task runs once per schedule,
+ * periodic tasks schedule themselves again.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef Scheduler_h
+#define Scheduler_h
+
+#include <Arduino.h>
+
+// Maximum number of tasks
+#define SCHEDULER_TASKS   6
+
+
+typedef void (*TaskFunction)(unsigned long now);
+
+
+class Scheduler {
+  public:
+    Scheduler();
+
+    void define(byte task, TaskFunction function);
+    void at(byte task, unsigned long time);
+    void after(byte task, unsigned long delay);
+    void cancel(byte task);
+    bool isScheduled(byte task);
+
+    void run(unsigned long now);
+    long untilNext(unsigned long now);
+
+  private:
+    TaskFunction functions[SCHEDULER_TASKS];
+    unsigned long deadlines[SCHEDULER_TASKS];
+    byte scheduled = 0;   // bit per task
+};
+
+#endif
@@ -0,0 +1,238 @@
+/*
+ * Class to play the lightshow of a trellis display while idle.
+ * A show is a sequence of keyframes stored in flash (LED mask, brightness and
+ * duration), played in a loop. The show is selected by name at runtime.
+ * Frames are shown at absolute deadlines (millis), a blocked loop skips frames
+ * instead of slowing the show down.
+ * The LEDs are changed in the trellis frame buffer only (see Matrix::flush()),
+ * every board of the matrix shows the same frame.
+ * 
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include "Show.h"
+
+// Constantly switch on all lights
+const Keyframe FRAMES_ALWAYS_ON[] PROGMEM = {
+  { 0xFFFF, 15,    0 },
+};
+
+// Switch on/off one by one all lights
+const Keyframe FRAMES_RUNNING[] PROGMEM = {
+  { 0x0000, 15,   20 },
+  { 0x0001, 15,   20 },
+  { 0x0003, 15,   20 },
+  { 0x0007, 15,   20 },
+  { 0x000F, 15,   20 },
+  { 0x001F, 15,   20 },
+  { 0x003F, 15,   20 },
+  { 0x007F, 15,   20 },
+  { 0x00FF, 15,   20 },
+  { 0x01FF, 15,   20 },
+  { 0x03FF, 15,   20 },
+  { 0x07FF, 15,   20 },
+  { 0x0FFF, 15,   20 },
+  { 0x1FFF, 15,   20 },
+  { 0x3FFF, 15,   20 },
+  { 0x7FFF, 15,   20 },
+  { 0xFFFF, 15, 1520 },
+  { 0xFFFE, 15,   20 },
+  { 0xFFFC, 15,   20 },
+  { 0xFFF8, 15,   20 },
+  { 0xFFF0, 15,   20 },
+  { 0xFFE0, 15,   20 },
+  { 0xFFC0, 15,   20 },
+  { 0xFF80, 15,   20 },
+  { 0xFF00, 15,   20 },
+  { 0xFE00, 15,   20 },
+  { 0xFC00, 15,   20 },
+  { 0xF800, 15,   20 },
+  { 0xF000, 15,   20 },
+  { 0xE000, 15,   20 },
+  { 0xC000, 15,   20 },
+  { 0x8000, 15,   20 },
+  { 0x0000, 15, 2500 },
+};
+
+// Pulse (fade-in/fade-out) all lights
+const Keyframe FRAMES_PULSING[] PROGMEM = {
+  { 0xFFFF,  0,  300 },
+  { 0xFFFF,  1,  300 },
+  { 0xFFFF,  2,  300 },
+  { 0xFFFF,  3,  300 },
+  { 0xFFFF,  4,  300 },
+  { 0xFFFF,  5,  300 },
+  { 0xFFFF,  6,  300 },
+  { 0xFFFF,  7,  300 },
+  { 0xFFFF,  8,  300 },
+  { 0xFFFF,  9,  300 },
+  { 0xFFFF, 10,  300 },
+  { 0xFFFF, 11,  300 },
+  { 0xFFFF, 12,  300 },
+  { 0xFFFF, 13,  300 },
+  { 0xFFFF, 14,  300 },
+  { 0xFFFF, 15,  300 },
+  { 0xFFFF, 14,  300 },
+  { 0xFFFF, 13,  300 },
+  { 0xFFFF, 12,  300 },
+  { 0xFFFF, 11,  300 },
+  { 0xFFFF, 10,  300 },
+  { 0xFFFF,  9,  300 },
+  { 0xFFFF,  8,  300 },
+  { 0xFFFF,  7,  300 },
+  { 0xFFFF,  6,  300 },
+  { 0xFFFF,  5,  300 },
+  { 0xFFFF,  4,  300 },
+  { 0xFFFF,  3,  300 },
+  { 0xFFFF,  2,  300 },
+  { 0xFFFF,  1,  300 },
+};
+
+// Pulse alternating halves of the lights
+const Keyframe FRAMES_ALTERNATING[] PROGMEM = {
+  { 0x5A5A,  0,  300 },
+  { 0x5A5A,  1,  300 },
+  { 0x5A5A,  2,  300 },
+  { 0x5A5A,  3,  300 },
+  { 0x5A5A,  4,  300 },
+  { 0x5A5A,  5,  300 },
+  { 0x5A5A,  6,  300 },
+  { 0x5A5A,  7,  300 },
+  { 0x5A5A,  8,  300 },
+  { 0x5A5A,  9,  300 },
+  { 0x5A5A, 10,  300 },
+  { 0x5A5A, 11,  300 },
+  { 0x5A5A, 12,  300 },
+  { 0x5A5A, 13,  300 },
+  { 0x5A5A, 14,  300 },
+  { 0x5A5A, 15,  300 },
+  { 0x5A5A, 14,  300 },
+  { 0x5A5A, 13,  300 },
+  { 0x5A5A, 12,  300 },
+  { 0x5A5A, 11,  300 },
+  { 0x5A5A, 10,  300 },
+  { 0x5A5A,  9,  300 },
+  { 0x5A5A,  8,  300 },
+  { 0x5A5A,  7,  300 },
+  { 0x5A5A,  6,  300 },
+  { 0x5A5A,  5,  300 },
+  { 0x5A5A,  4,  300 },
+  { 0x5A5A,  3,  300 },
+  { 0x5A5A,  2,  300 },
+  { 0x5A5A,  1,  300 },
+  { 0x0000,  0,  300 },
+  { 0xA5A5,  0,  300 },
+  { 0xA5A5,  1,  300 },
+  { 0xA5A5,  2,  300 },
+  { 0xA5A5,  3,  300 },
+  { 0xA5A5,  4,  300 },
+  { 0xA5A5,  5,  300 },
+  { 0xA5A5,  6,  300 },
+  { 0xA5A5,  7,  300 },
+  { 0xA5A5,  8,  300 },
+  { 0xA5A5,  9,  300 },
+  { 0xA5A5, 10,  300 },
+  { 0xA5A5, 11,  300 },
+  { 0xA5A5, 12,  300 },
+  { 0xA5A5, 13,  300 },
+  { 0xA5A5, 14,  300 },
+  { 0xA5A5, 15,  300 },
+  { 0xA5A5, 14,  300 },
+  { 0xA5A5, 13,  300 },
+  { 0xA5A5, 12,  300 },
+  { 0xA5A5, 11,  300 },
+  { 0xA5A5, 10,  300 },
+  { 0xA5A5,  9,  300 },
+  { 0xA5A5,  8,  300 },
+  { 0xA5A5,  7,  300 },
+  { 0xA5A5,  6,  300 },
+  { 0xA5A5,  5,  300 },
+  { 0xA5A5,  4,  300 },
+  { 0xA5A5,  3,  300 },
+  { 0xA5A5,  2,  300 },
+  { 0xA5A5,  1,  300 },
+  { 0x0000,  0,  300 },
+};
+
+const char NAME_ALWAYS_ON[] PROGMEM = SHOW_ALWAYS_ON;
+const char NAME_RUNNING[] PROGMEM = SHOW_RUNNING;
+const char NAME_PULSING[] PROGMEM = SHOW_PULSING;
+const char NAME_ALTERNATING[] PROGMEM = SHOW_ALTERNATING;
+
+const ShowDefinition SHOWS[] PROGMEM = {
+  { NAME_ALWAYS_ON, FRAMES_ALWAYS_ON, sizeof(FRAMES_ALWAYS_ON) / sizeof(Keyframe) },
+  { NAME_RUNNING, FRAMES_RUNNING, sizeof(FRAMES_RUNNING) / sizeof(Keyframe) },
+  { NAME_PULSING, FRAMES_PULSING, sizeof(FRAMES_PULSING) / sizeof(Keyframe) },
+  { NAME_ALTERNATING, FRAMES_ALTERNATING, sizeof(FRAMES_ALTERNATING) / sizeof(Keyframe) },
+};
+
+
+Show::Show(Trellis* boards)
+: boards(boards) {}
+
+/*
+ * Select the show by its name, the current show is kept for an unknown name.
+ */
+bool Show::select(const char* name) {
+  for (byte i = 0; i < sizeof(SHOWS) / sizeof(ShowDefinition); i++) {
+    ShowDefinition show;
+    memcpy_P(&show, &SHOWS[i], sizeof(show));
+    if (strcmp_P(name, show.name) == 0) {
+      frames = show.frames;
+      count = show.count;
+      return true;
+    }
+  }
+  Serial.print(F("Unknown show ")); Serial.println(name);
+  return false;
+}
+
+void Show::initialize(unsigned long now) {
+  index = 0;
+  brightness = 0xFF;
+  for (byte b = 0; b < TRELLIS_BOARDS; b++) {
+    boards[b].blinkRate(HT16K33_BLINK_OFF);
+  }
+  readFrame();
+  showFrame();
+  deadline = now + frame.duration;
+}
+
+/*
+ * Show the last due frame, frames missed while the loop was blocked are skipped.
+ * Returns the milliseconds until the next frame, -1 if the frame is held.
+ */
+long Show::run(unsigned long now) {
+  if (frame.duration == 0) return -1;
+
+  bool due = false;
+  while (frame.duration != 0 && (int32_t)(now - deadline) >= 0) {
+    index = (index + 1) % count;
+    readFrame();
+    deadline += frame.duration;
+    due = true;
+  }
+  if (due) showFrame();
+  return frame.duration == 0 ? -1 : (int32_t)(deadline - now);
+}
+
+void Show::readFrame() {
+  memcpy_P(&frame, &frames[index], sizeof(frame));
+}
+
+void Show::showFrame() {
+  bool dimmed = frame.brightness != brightness;
+  brightness = frame.brightness;
+  for (byte b = 0; b < TRELLIS_BOARDS; b++) {
+    for (byte i = 0; i < TRELLIS_KEYS; i++) {
+      if (frame.leds & bit(i)) {
+        boards[b].setLED(i);
+      } else {
+        boards[b].clrLED(i);
+      }
+    }
+    if (dimmed) boards[b].setBrightness(brightness);
+  }
+}
@@ -0,0 +1,60 @@
+/*
+ * Class to play the lightshow of a trellis display while idle.
+ * A show is a sequence of keyframes stored in flash (LED mask, brightness and
+ * duration), played in a loop. The show is selected by name at runtime.
+ * Frames are shown at absolute deadlines (millis), a blocked loop skips frames
+ * instead of slowing the show down.
+ * The LEDs are changed in the trellis frame buffer only (see Matrix::flush()),
+ * every board of the matrix shows the same frame.
+ * 
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef Show_h
+#define Show_h
+
+#include <Arduino.h>
+#include "TracedTrellis.h"
+
+// Shows (see settings.cfg)
+#define SHOW_ALWAYS_ON    "alwayson"
+#define SHOW_RUNNING      "running"
+#define SHOW_PULSING      "pulsing"
+#define SHOW_ALTERNATING  "alternating"
+
+
+struct Keyframe {
+  uint16_t leds;          // bit per key of a board, set = on
+  byte brightness;        // 0..15
+  uint16_t duration;      // until the next frame [ms], 0 = hold
+};
+
+struct ShowDefinition {
+  const char* name;       // in flash
+  const Keyframe* frames; // in flash
+  byte count;
+};
+
+
+class Show {
+  public:
+    Show(Trellis* boards);
+    bool select(const char* name);
+    void initialize(unsigned long now);
+    long run(unsigned long now);
+
+  private:
+    Trellis* boards;
+    const Keyframe* frames = NULL;
+    byte count = 0;
+    byte index;
+    byte brightness;
+    Keyframe frame;
+    unsigned long deadline;   // of the next frame
+
+    void readFrame();
+    void showFrame();
+};
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * Class to cache the configuration of recently used nfc tags in RAM, the path
+ * itself when it is short enough, otherwise its offset in nfc.cfg. A hit with
+ * the path does not access the SD card at all.
+ * Open addressing with a bounded probe window, the least recently used slot
+ * of the window is replaced when the window is full.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include "TagCache.h"
+
+
+TagCache::TagCache() {
+  clear();
+}
+
+void TagCache::clear() {
+  memset(slots, 0, sizeof(slots));
+}
+
+/*
+ * Return the cached offset of the tag, -1 if not cached. The cached path is copied
+ * into the buffer, it is empty when the path has to be read at the offset.
+ */
+long TagCache::get(const TagId& id, char* path, byte size) {
+  if (path && size > 0) path[0] = '\0';
+  TagCacheSlot* slot = find(id);
+  if (!slot) {
+    misses++;
+    return -1;
+  }
+  hits++;
+  slot->lastUsed = ++useCounter;
+  if (path && size > strlen(slot->path)) {
+    strcpy(path, slot->path);
+  }
+  return slot->offset;
+}
+
+/*
+ * Cache the offset of the tag and its path unless longer than TAG_CACHE_PATH_LENGTH - 1.
+ */
+void TagCache::put(const TagId& id, uint32_t offset, const char* path) {
+  if (id.length == 0 || id.length > TAG_UID_LENGTH) return;
+
+  TagCacheSlot* slot = find(id);
+  if (!slot) {
+    // empty or least recently used slot of the probe window
+    byte index = hash(id);
+    for (byte i = 0; i < TAG_CACHE_PROBES; i++) {
+      TagCacheSlot* candidate = &slots[(index + i) & (TAG_CACHE_SIZE - 1)];
+      if (candidate->id.length == 0) {
+        slot = candidate;
+        break;
+      }
+      if (!slot || (uint16_t)(useCounter - candidate->lastUsed) > (uint16_t)(useCounter - slot->lastUsed)) {
+        slot = candidate;
+      }
+    }
+    slot->id = id;
+  }
+  slot->offset = offset;
+  slot->lastUsed = ++useCounter;
+  if (path && strlen(path) < TAG_CACHE_PATH_LENGTH) {
+    strcpy(slot->path, path);
+  } else {
+    slot->path[0] = '\0';
+  }
+}
+
+TagCacheSlot* TagCache::find(const TagId& id) {
+  if (id.length == 0) return NULL;   // would match an empty slot
+  byte index = hash(id);
+  for (byte i = 0; i < TAG_CACHE_PROBES; i++) {
+    TagCacheSlot* slot = &slots[(index + i) & (TAG_CACHE_SIZE - 1)];
+    if (slot->id == id) {
+      return slot;
+    }
+  }
+  return NULL;
+}
+
+/*
+ * FNV-1a hash of the uid bytes.
+ */
+byte TagCache::hash(const TagId& id) {
+  uint32_t value = 0x811C9DC5;
+  for (byte i = 0; i < id.length; i++) {
+    value = (value ^ id.uid[i]) * 0x01000193;
+  }
+  return (value ^ (value >> 16)) & (TAG_CACHE_SIZE - 1);
+}
+
+void TagCache::printStatistics() {
+  Serial.print(F("Tag cache hits ")); Serial.print(hits);
+  Serial.print(F(", misses ")); Serial.println(misses);
+}
@@ -0,0 +1,51 @@
+/*
+ * Class to cache the configuration of recently used nfc tags in RAM, the path
+ * itself when it is short enough, otherwise its offset in nfc.cfg. A hit with
+ * the path does not access the SD card at all.
+ * Open addressing with a bounded probe window, the least recently used slot
+ * of the window is replaced when the window is full.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef TagCache_h
+#define TagCache_h
+
+#include <Arduino.h>
+#include "TagId.h"
+
+// Cache setup (38 bytes per slot)
+#define TAG_CACHE_SIZE         8    // power of 2
+#define TAG_CACHE_PROBES       4
+#define TAG_CACHE_PATH_LENGTH 24    // cached path incl. terminating zero, longer ones by offset
+
+
+struct TagCacheSlot {
+  TagId id;               // length 0 = empty slot
+  uint32_t offset;        // file offset of the path in nfc.cfg
+  uint16_t lastUsed;
+  char path[TAG_CACHE_PATH_LENGTH];   // empty if too long
+};
+
+
+class TagCache {
+  public:
+    TagCache();
+
+    long get(const TagId& id, char* path = NULL, byte size = 0);
+    void put(const TagId& id, uint32_t offset, const char* path = NULL);
+    void clear();
+    void printStatistics();
+
+  private:
+    TagCacheSlot slots[TAG_CACHE_SIZE];
+    uint16_t useCounter = 0;
+    uint16_t hits = 0;
+    uint16_t misses = 0;
+
+    TagCacheSlot* find(const TagId& id);
+    static byte hash(const TagId& id);
+};
+
+#endif
@@ -0,0 +1,44 @@
+/*
+ * Value type holding the uid of an nfc tag, formatted as hex without heap allocation.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef TagId_h
+#define TagId_h
+
+#include <Arduino.h>
+
+// Length of uid is 4 bytes (Mifare Classic) or 7 bytes (Mifare Ultralight)
+#define TAG_UID_LENGTH   7
+#define TAG_HEX_LENGTH   (2 * TAG_UID_LENGTH + 1)    // incl. terminating zero
+
+
+struct TagId {
+  byte length;
+  byte uid[TAG_UID_LENGTH];
+
+  bool operator==(const TagId& other) const {
+    return length == other.length && memcmp(uid, other.uid, length) == 0;
+  }
+
+  /*
+   * Format as uppercase hex into the buffer of (at least) TAG_HEX_LENGTH chars.
+   */
+  const char* toHex(char* buffer) const {
+    byte i = 0;
+    for (; i < length && i < TAG_UID_LENGTH; i++) {
+      buffer[2 * i] = hexDigit(uid[i] >> 4);
+      buffer[2 * i + 1] = hexDigit(uid[i] & 0x0F);
+    }
+    buffer[2 * i] = '\0';
+    return buffer;
+  }
+
+  static constexpr char hexDigit(byte nibble) {
+    return nibble < 10 ? '0' + nibble : 'A' + nibble - 10;
+  }
+};
+
+#endif
@@ -0,0 +1,57 @@
+/*
+ * Trellis with traced I2C transactions (see BusTrace), the plain Adafruit_Trellis
+ * is used when tracing is disabled.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include "TracedTrellis.h"
+
+#ifdef BUS_TRACE
+
+void TracedTrellis::begin(uint8_t address) const {
+  unsigned long start = micros();
+  Adafruit_Trellis::begin(address);
+  busTrace.record(BUS_TRELLIS, 4, start);    // oscillator, blink rate, brightness, interrupt
+}
+
+void TracedTrellis::setBrightness(uint8_t b) const {
+  unsigned long start = micros();
+  Adafruit_Trellis::setBrightness(b);
+  busTrace.record(BUS_TRELLIS, 1, start);
+}
+
+void TracedTrellis::blinkRate(uint8_t b) const {
+  unsigned long start = micros();
+  Adafruit_Trellis::blinkRate(b);
+  busTrace.record(BUS_TRELLIS, 1, start);
+}
+
+void TracedTrellis::writeDisplay(void) const {
+  unsigned long start = micros();
+  Adafruit_Trellis::writeDisplay();
+  busTrace.record(BUS_TRELLIS, 17, start);   // address and 8 rows of leds
+}
+
+boolean TracedTrellis::readSwitches(void) const {
+  unsigned long start = micros();
+  boolean changed = Adafruit_Trellis::readSwitches();
+  busTrace.record(BUS_TRELLIS, 7, start);    // address, 6 bytes of keys
+  return changed;
+}
+
+void TracedTrellis::sleep(void) const {
+  unsigned long start = micros();
+  Adafruit_Trellis::sleep();
+  busTrace.record(BUS_TRELLIS, 1, start);
+}
+
+void TracedTrellis::wakeup(void) const {
+  unsigned long start = micros();
+  Adafruit_Trellis::wakeup();
+  busTrace.record(BUS_TRELLIS, 1, start);
+}
+
+#endif
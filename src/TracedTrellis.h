@@ -0,0 +1,43 @@
+/*
+ * Trellis with traced I2C transactions (see BusTrace), the plain Adafruit_Trellis
+ * is used when tracing is disabled.
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef TracedTrellis_h
+#define TracedTrellis_h
+
+#include <Arduino.h>
+#include <Adafruit_Trellis.h>
+#include "BusTrace.h"
+
+// Trellis boards at consecutive addresses, 16 keys each
+#define TRELLIS_BOARDS     1    // 1..8
+#define TRELLIS_KEYS      16
+#define NUMKEYS           (TRELLIS_BOARDS * TRELLIS_KEYS)
+
+#ifdef BUS_TRACE
+
+// Same signatures as the (const) methods of Adafruit_Trellis they hide
+class TracedTrellis : public Adafruit_Trellis {
+  public:
+    void begin(uint8_t address = 0x70) const;
+    void setBrightness(uint8_t b) const;
+    void blinkRate(uint8_t b) const;
+    void writeDisplay(void) const;
+    boolean readSwitches(void) const;
+    void sleep(void) const;
+    void wakeup(void) const;
+};
+
+typedef TracedTrellis Trellis;
+
+#else
+
+typedef Adafruit_Trellis Trellis;
+
+#endif
+
+#endif
@@ -0,0 +1,171 @@
+/*
+ * Class to list the audio tracks of an album folder in name order.
+ * The list is stored as a cache file in the album folder and built on first use,
+ * so that each track is found by its index without walking the directory.
+ * The header holds the number and total size of the audio files, the list is
+ * rebuilt on open when the directory entries of the folder differ (tracks added,
+ * removed or replaced).
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+
+#include "TrackList.h"
+
+// Extensions decoded by the VS1053
+const char* const AUDIO_EXTENSIONS[] = { "MP3", "OGG", "WAV", "WMA", "AAC", "M4A", "MID" };
+
+
+/*
+ * Open the list of the album, (re)built if missing or stale. Checking the list reads
+ * the directory entries (16 per block) but no track.
+ */
+bool TrackList::open(const char* albumPath) {
+  close();
+  listPath = albumPath;
+  if (listPath.charAt(listPath.length() - 1) != '/') {
+    listPath += '/';
+  }
+  listPath += TRACKLIST_NAME;
+
+  list = SD.open(listPath.c_str());
+  TrackListHeader header;
+  uint16_t count;
+  uint32_t bytes;
+  if (list && list.read((byte*)&header, sizeof(header)) == sizeof(header)
+      && memcmp(header.magic, TRACKLIST_MAGIC, sizeof(header.magic)) == 0
+      && summarize(albumPath, count, bytes) && header.count == count && header.bytes == bytes) {
+    trackCount = header.count;
+    return true;
+  }
+  list.close();
+  return build(albumPath);
+}
+
+void TrackList::close() {
+  list.close();
+  trackCount = 0;
+}
+
+/*
+ * Remove the cache, e.g. when a listed track is missing. It is rebuilt on the next open.
+ */
+void TrackList::invalidate() {
+  close();
+  SD.remove(listPath.c_str());
+}
+
+uint16_t TrackList::count() {
+  return trackCount;
+}
+
+/*
+ * Copy the name of the track into the buffer of (at least) TRACK_NAME_LENGTH + 1 chars.
+ */
+bool TrackList::getName(uint16_t index, char* name) {
+  if (index >= trackCount) return false;
+  TrackEntry entry;
+  list.seek(sizeof(TrackListHeader) + (uint32_t)index * sizeof(TrackEntry));
+  if (list.read((byte*)&entry, sizeof(entry)) != sizeof(entry)) return false;
+  memcpy(name, entry.name, TRACK_NAME_LENGTH);
+  name[TRACK_NAME_LENGTH] = '\0';
+  return true;
+}
+
+/*
+ * Walk the album folder once, write an entry per audio file and sort them by name.
+ * The header is written last, an interrupted build leaves an invalid list.
+ */
+bool TrackList::build(const char* albumPath) {
+  Serial.print(F("Build track list ")); Serial.println(listPath);
+  File album = SD.open(albumPath);
+  if (!album || !album.isDirectory()) {
+    album.close();
+    return false;
+  }
+
+  SD.remove(listPath.c_str());
+  list = SD.open(listPath.c_str(), O_READ | O_WRITE | O_CREAT);
+  if (!list) {
+    album.close();
+    return false;
+  }
+
+  TrackListHeader header;
+  memset(&header, 0, sizeof(header));
+  list.write((const byte*)&header, sizeof(header));
+
+  uint16_t count = 0;
+  uint32_t bytes = 0;
+  while (count < 0xFFFF) {
+    File track = album.openNextFile();
+    if (!track) break;
+    if (!track.isDirectory() && isAudioFile(track.name())) {
+      TrackEntry entry;
+      memset(&entry, 0, sizeof(entry));
+      strncpy(entry.name, track.name(), TRACK_NAME_LENGTH);
+      list.write((const byte*)&entry, sizeof(entry));
+      count++;
+      bytes += track.size();
+    }
+    track.close();
+  }
+  album.close();
+
+  FileSort::sort(list, sizeof(TrackListHeader), count, compareRecords);
+
+  memcpy(header.magic, TRACKLIST_MAGIC, sizeof(header.magic));
+  header.count = count;
+  header.bytes = bytes;
+  list.seek(0);
+  list.write((const byte*)&header, sizeof(header));
+  list.flush();
+  trackCount = count;
+  Serial.print(count); Serial.println(F(" tracks listed"));
+  return true;
+}
+
+/*
+ * Number and total size of the audio files in the album folder, read from its
+ * raw directory entries without opening a track.
+ */
+bool TrackList::summarize(const char* albumPath, uint16_t& count, uint32_t& bytes) {
+  File album = SD.open(albumPath);
+  if (!album || !album.isDirectory()) {
+    album.close();
+    return false;
+  }
+  count = 0;
+  bytes = 0;
+  dir_t entry;
+  while (count < 0xFFFF && album.read(&entry, sizeof(entry)) == sizeof(entry) && entry.name[0] != DIR_NAME_FREE) {
+    char extension[4];
+    memcpy(extension, entry.name + 8, 3);
+    extension[3] = '\0';
+    char* blank = strchr(extension, ' ');
+    if (blank) *blank = '\0';
+    if (entry.name[0] != DIR_NAME_DELETED && DIR_IS_FILE(&entry) && isAudioExtension(extension)) {
+      count++;
+      bytes += entry.fileSize;
+    }
+  }
+  album.close();
+  return true;
+}
+
+bool TrackList::isAudioFile(const char* name) {
+  const char* dot = strrchr(name, '.');
+  return dot && isAudioExtension(dot + 1);
+}
+
+bool TrackList::isAudioExtension(const char* extension) {
+  for (byte i = 0; i < sizeof(AUDIO_EXTENSIONS) / sizeof(AUDIO_EXTENSIONS[0]); i++) {
+    if (strcasecmp(extension, AUDIO_EXTENSIONS[i]) == 0) return true;
+  }
+  return false;
+}
+
+int TrackList::compareRecords(const byte* a, const byte* b) {
+  return strncmp(((const TrackEntry*)a)->name, ((const TrackEntry*)b)->name, TRACK_NAME_LENGTH);
+}
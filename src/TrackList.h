@@ -0,0 +1,62 @@
+/*
+ * Class to list the audio tracks of an album folder in name order.
+ * The list is stored as a cache file in the album folder and built on first use,
+ * so that each track is found by its index without walking the directory.
+ * The header holds the number and total size of the audio files, the list is
+ * rebuilt on open when the directory entries of the folder differ (tracks added,
+ * removed or replaced).
+ *
+ * Written by Jörg Keller, Winterthur, Switzerland
+ * https://github.com/joergkeller/arduino-musicbox
+ * MIT license, all text above must be included in any redistribution
+ */
+#ifndef TrackList_h
+#define TrackList_h
+
+#include <Arduino.h>
+#include <SD.h>
+#include "FileSort.h"
+
+// Cache file in each album folder
+#define TRACKLIST_NAME     "_TRACKS.LST"
+#define TRACKLIST_MAGIC    "MBT2"
+
+// 8.3 file name (without terminating zero)
+#define TRACK_NAME_LENGTH  12
+
+
+struct TrackListHeader {
+  char magic[4];
+  uint32_t bytes;                 // total size of the tracks
+  uint16_t count;
+  byte reserved[6];
+};
+
+struct TrackEntry {
+  char name[TRACK_NAME_LENGTH];   // zero padded
+  byte reserved[SORT_RECORD_SIZE - TRACK_NAME_LENGTH];
+};
+
+
+class TrackList {
+  public:
+    bool open(const char* albumPath);
+    void close();
+    void invalidate();
+
+    uint16_t count();
+    bool getName(uint16_t index, char* name);
+
+  private:
+    String listPath = String();
+    File list;
+    uint16_t trackCount = 0;
+
+    bool build(const char* albumPath);
+    static bool summarize(const char* albumPath, uint16_t& count, uint32_t& bytes);
+    static bool isAudioFile(const char* name);
+    static bool isAudioExtension(const char* extension);
+    static int compareRecords(const byte* a, const byte* b);
+};
+
+#endif
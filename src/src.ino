@@ -26,22 +26,27 @@
 #include <ClickEncoder.h>
 #include <TimerOne.h>
 #include <LowPower.h>
-#include <PN532_I2C.h>
-#include <PN532.h>
+#include <Properties.h>
 #undef NULL
 #include <NfcAdapter.h>
-#include <Properties.h>
 #include "Matrix.h"
 #include "Player.h"
+#include "ConfigIndex.h"
+#include "TagCache.h"
+#include "TagId.h"
+#include "Scheduler.h"
+#include "Latency.h"
+#include "NfcReader.h"
+#include "BusTrace.h"
 
 
 // Delays [ms]
 #define PAUSE_DELAY    1000
 #define READ_DELAY       50
-#define NFC_DELAY      1000
+#define NFC_DELAY        20    // check of the nfc irq pin
+#define TRACK_DELAY      10
 #define IDLE_TIMEOUT  (1000L * 60L * 15L)
 #define PAUSE_TIMEOUT (1000L * 60L * 60L)
-#define ROLLOVER_GAP  (1000L * 60L * 60L)
 
 // Rotary Encoder with Switch and LED
 #define ENCODER_A_PIN       A0
@@ -52,17 +57,19 @@
 #define BLUE_LED_PIN        A5
 #define VOLUME_DIRECTION    -3    // set direction of encoder-volume
 
-// NFC pin setup
-#define NFC_RESET_PIN   13    // PN532 reset pin
-
 // States
 #define IDLE            1
 #define PLAY_SELECTED   2
 #define PLAY_PAUSED     3
 #define TIMEOUT_WAIT    4 
 
-// NFC reader
-#define NFC_RETRIES   0    // 0 = one try, 255 = retry forever
+// Tasks (run in this order when due at the same time)
+#define TASK_TIMEOUT      0    // timeout check first to go back to sleep mode after blink
+#define TASK_READ_INPUT   1
+#define TASK_READ_NFC     2
+#define TASK_IDLE_SHOW    3
+#define TASK_TRACK_END    4
+#define TASK_ANIMATE      5
 
 /***************************************************
    Variables
@@ -70,17 +77,14 @@
 Matrix matrix = Matrix();
 Player player = Player();
 ClickEncoder encoder = ClickEncoder(ENCODER_A_PIN, ENCODER_B_PIN, ENCODER_SWITCH_PIN, 2, LOW, HIGH);
-PN532_I2C pn532i2c(Wire);
-PN532 nfc(pn532i2c);
-
-
-unsigned long nextReadTick = millis() + 1;
-unsigned long nextNfcTick = millis() + 1;
-unsigned long nextIdleTick = millis() + 1;
-unsigned long nextTimeoutTick = 0;
+NfcReader nfc = NfcReader();
+ConfigIndex buttonsCfg = ConfigIndex("buttons.cfg", "buttons.idx");
+ConfigIndex nfcCfg = ConfigIndex("nfc.cfg", "nfc.idx");
+TagCache tagCache = TagCache();
+Latency latency = Latency();
+Scheduler scheduler = Scheduler();
 byte state = IDLE;
 byte playingAlbum;
-bool tickMs = false;
 
 
 /***************************************************
@@ -88,14 +92,16 @@ bool tickMs = false;
  ****************************************************/
 void setup() {
   Serial.begin(19200);
-  while (!Serial && millis() < nextIdleTick + 75);
+  while (!Serial && millis() < 76);
   Serial.println(F("MusicBox setup"));
 
   matrix.initialize();
   player.initialize();
+  initializeConfig();
   initializeSwitchLed();                    
   initializeNfc();
   initializeTimer();
+  initializeTasks();
 
   onEnterIdle(0);
 }
@@ -109,21 +115,23 @@ void initializeSwitchLed() {
   digitalWrite(BLUE_LED_PIN, HIGH);  // LED off
 }
 
-void initializeNfc() {
-  pinMode(NFC_RESET_PIN, OUTPUT);
-  digitalWrite(NFC_RESET_PIN, HIGH);
-  nfc.begin();
-  uint32_t versiondata = nfc.getFirmwareVersion();
-  if (!versiondata) {
-    Serial.println(F("PN532 failed"));
-    return;
+void initializeConfig() {
+  buttonsCfg.initialize();
+  nfcCfg.initialize();
+
+  // settings are read once, not indexed
+  File file = SD.open("settings.cfg");
+  Properties settings = Properties(file);
+  String show = settings.readString(String("idle.show"));
+  file.close();
+  if (show.length() != 0) {
+    matrix.selectShow(show.c_str());
   }
+  Serial.println(F("Config initialized"));
+}
 
-  // Set the max number of retry attempts to read from a card.
-  // This prevents us from waiting forever for a card, which is the default behaviour of the PN532.
-  nfc.setPassiveActivationRetries(NFC_RETRIES);
-  nfc.SAMConfig();  
-  Serial.println(F("PN532 initialized"));
+void initializeNfc() {
+  nfc.initialize();
 }
 
 void initializeTimer() {
@@ -132,15 +140,25 @@ void initializeTimer() {
   Serial.println(F("Timer initialized"));
 }
 
+void initializeTasks() {
+  scheduler.define(TASK_TIMEOUT, tickIdleTimeout);
+  scheduler.define(TASK_READ_INPUT, tickReadInput);
+  scheduler.define(TASK_READ_NFC, tickReadNfc);
+  scheduler.define(TASK_IDLE_SHOW, tickIdleShow);
+  scheduler.define(TASK_TRACK_END, tickTrackEnd);
+  scheduler.define(TASK_ANIMATE, tickAnimate);
+}
+
 void onEnterIdle(unsigned int delay) {
   state = IDLE;
   matrix.idle();
   enableNfc(true);
 
-  nextReadTick = millis() + 1;
-  nextNfcTick = millis() + 1;
-  nextIdleTick = millis() + 1 + delay;
-  nextTimeoutTick = millis() + IDLE_TIMEOUT;
+  scheduler.after(TASK_READ_INPUT, 1);
+  scheduler.after(TASK_READ_NFC, 1);
+  scheduler.after(TASK_IDLE_SHOW, 1 + delay);
+  scheduler.after(TASK_ANIMATE, 0);
+  scheduler.after(TASK_TIMEOUT, IDLE_TIMEOUT);
 }
 
 
@@ -149,7 +167,11 @@ void onEnterIdle(unsigned int delay) {
  ****************************************************/
 void timerIsr() {
   encoder.service();
-  tickMs = true;
+}
+
+// Pin change of the VS1053 data request (DREQ)
+ISR(PCINT0_vect) {
+  player.feed();
 }
 
 void trellisIsr() {
@@ -161,37 +183,20 @@ void trellisIsr() {
    Loop
  ****************************************************/
 void loop() {
-  unsigned long now = millis();
-
-  // Rollover millis since start
-  if (nextReadTick > now + ROLLOVER_GAP) {
-    Serial.println(F("Rollover timer ticks!"));
-    nextReadTick = now + 1;
-    nextIdleTick = now + 1;
-    nextTimeoutTick = nextTimeoutTick == 0 ? 0 : now + IDLE_TIMEOUT;
-  }
-
-  // Next ticks (timeout check first to go back to sleep mode after blink)
-  if (0 < nextTimeoutTick && nextTimeoutTick <= now) {
-    tickIdleTimeout(now);
-  }
-  if (0 < nextReadTick && nextReadTick <= now) {
-    tickReadKeys(now);
+  player.fill();
+#ifdef LATENCY_CSV
+  unsigned long firstFeed;
+  if (player.getFirstFeed(firstFeed)) {
+    latency.stop(firstFeed);
   }
-  if (0 < nextNfcTick && nextNfcTick <= now) {
-    tickReadNfc(now);
-  }
-  if (0 < nextIdleTick && nextIdleTick <= now) {
-    tickIdleShow(now);
-  }
-  if (tickMs) {
-    matrix.tickMs();
-    tickMs = false;
-  }
-
-  // Check for finished track
-  if (state == PLAY_SELECTED) {
-    if (player.hasStopped()) onTryNextTrack();
+#endif
+  readKeys();
+  scheduler.run(millis());
+  matrix.flush();
+
+  // Idle the cpu until the next interrupt (timer, trellis keys) unless a task is due
+  if (scheduler.untilNext(millis()) != 0) {
+    LowPower.idle(SLEEP_FOREVER, ADC_OFF, TIMER4_OFF, TIMER3_OFF, TIMER1_ON, TIMER0_ON, SPI_ON, USART1_ON, TWI_ON, USB_ON);
   }
 }
 
@@ -199,7 +204,30 @@ void tickIdleShow(unsigned long now) {
   // Blink in pause mode
   if (state == PLAY_PAUSED) {
     blinkLED(BLUE_LED_PIN);
-    nextIdleTick = now + PAUSE_DELAY;
+    scheduler.at(TASK_IDLE_SHOW, now + PAUSE_DELAY);
+  }
+}
+
+void tickAnimate(unsigned long now) {
+  // Next frame of the idle show at its deadline
+  long wait = matrix.animate(now);
+  if (wait >= 0) {
+    scheduler.at(TASK_ANIMATE, now + wait);
+  }
+}
+
+void tickTrackEnd(unsigned long now) {
+  // Prepare the next track and check for finished track
+  if (state == PLAY_SELECTED) {
+    player.prefetchTrack();
+    if (!player.continueTrack() && player.hasStopped()) {
+      player.printStatistics();
+      latency.start(F("track"));
+      onTryNextTrack();
+    }
+  }
+  if (state == PLAY_SELECTED || state == PLAY_PAUSED) {
+    scheduler.at(TASK_TRACK_END, now + TRACK_DELAY);
   }
 }
 
@@ -213,6 +241,7 @@ void tickIdleTimeout(unsigned long now) {
   if (state == TIMEOUT_WAIT) {
     // temporary wakeup after 8s, no interrupt called
     onWatchdogPing();
+    scheduler.after(TASK_TIMEOUT, 0);
   } else {
     onSleepWake();
   }
@@ -243,13 +272,15 @@ void blinkLED(int pin) {
   digitalWrite(pin, HIGH); // LED off
 }
 
-void tickReadKeys(unsigned long now) {
-  // Read trellis keys
-  int index = matrix.getPressedKey();
+void readKeys() {
+  // Trellis keys signaled by its INT line
+  int index = matrix.getPressedKey(millis());
   if (index != -1) {
     onKey(index);
   }
+}
 
+void tickReadInput(unsigned long now) {
   // Read encoder position
   if (state == PLAY_SELECTED) {
     int encoderChange = encoder.getValue() * VOLUME_DIRECTION;
@@ -282,7 +313,7 @@ void tickReadKeys(unsigned long now) {
         blinkLED(GREEN_LED_PIN);
         delay(300);
         blinkLED(RED_LED_PIN);
-        nextTimeoutTick = millis();
+        scheduler.after(TASK_TIMEOUT, 0);
       break;
     }
   } else if (button == ClickEncoder::Released) {
@@ -290,29 +321,32 @@ void tickReadKeys(unsigned long now) {
   }
 
   player.checkHeadphoneLevel();
+
+#ifdef BUS_TRACE
+  if (Serial.available() && Serial.read() == 'b') {
+    busTrace.print();
+  }
+#endif
   
-  nextReadTick = now + READ_DELAY;
+  scheduler.at(TASK_READ_INPUT, now + READ_DELAY);
 }
 
-unsigned long tickReadNfc(unsigned long now) {
-  // Wait for an ISO14443A type cards (Mifare, etc.).
-  // Length of uid is 4 bytes (Mifare Classic) or 7 bytes (Mifare Ultralight).
-  byte uid[] = { 0, 0, 0, 0, 0, 0, 0 };  // Buffer to store the returned UID
-  byte uidLength;                        // Length of the UID (4 or 7 bytes depending on ISO14443A card type)
-  if (nfc.readPassiveTargetID(PN532_MIFARE_ISO14443A, &uid[0], &uidLength)) {
-    String hexId = String("");
-    for (uint8_t i=0; i < uidLength; i++) {
-      if (uid[i] < 0x10) {
-        hexId += '0';
-      }
-      hexId += String(uid[i], HEX);
+void tickReadNfc(unsigned long now) {
+  // Try again later unless a card starts playing
+  scheduler.at(TASK_READ_NFC, now + NFC_DELAY);
+  if (!nfc.hasCard()) return;
+
+  // Read the ISO14443A type card (Mifare, etc.) found by polling
+  TagId id = { 0 };
+  if (nfc.readCard(id)) {
+    char hexId[TAG_HEX_LENGTH];
+    Serial.print(F("NFC UID: 0x")); Serial.println(id.toHex(hexId));
+    latency.start(F("nfc"));
+    onNfcId(id);
+    if (state == IDLE) {
+      nfc.ignore(id); // not played, e.g. unknown
+      nfc.startPolling();
     }
-    hexId.toUpperCase();
-    Serial.print(F("NFC UID: 0x")); Serial.println(hexId);
-    onNfcId(hexId);
-  } else {
-    // No NFC card found, try again
-    nextNfcTick = now + NFC_DELAY;
   }
 }
 
@@ -324,29 +358,28 @@ void onKey(byte index) {
 
   // Same key pressed again
   } else if (state == PLAY_SELECTED && playingAlbum == index) {
-    nextTimeoutTick = 0; // no timeout during playing
-    nextNfcTick = 0; // no nfc reading during playing
+    latency.start(F("next"));
+    scheduler.cancel(TASK_TIMEOUT); // no timeout during playing
+    scheduler.cancel(TASK_READ_NFC); // no nfc reading during playing
     player.stop();
     onTryNextTrack();
 
   // Some (other) key pressed
   } else {
+    latency.start(F("key"));
     if (state == PLAY_SELECTED) { player.stop(); }
     matrix.blink(index, true);
-    nextTimeoutTick = 0; // no timeout during playing
-    nextNfcTick = 0; // no nfc reading during playing
+    scheduler.cancel(TASK_TIMEOUT); // no timeout during playing
+    scheduler.cancel(TASK_READ_NFC); // no nfc reading during playing
     enableNfc(false);
     player.enable(true);
 
-    File file = SD.open("buttons.cfg");
-    Properties cfg = Properties(file);
-    String key = String(index);
-    String path = cfg.readString(key);
-    file.close();
-    
-    if (path.length() != 0 && player.startPlaying(path.c_str())) {
+    char key[4];
+    char path[CONFIG_VALUE_LENGTH];
+    if (buttonsCfg.lookup(itoa(index, key, 10), path, sizeof(path)) && player.startPlaying(path)) {
       state = PLAY_SELECTED;
       playingAlbum = index;
+      scheduler.after(TASK_TRACK_END, TRACK_DELAY);
       Serial.print(F("Playing album #")); Serial.println(playingAlbum);
     } else {
       Serial.print(F("Failed album #")); Serial.println(playingAlbum);
@@ -355,37 +388,61 @@ void onKey(byte index) {
   }
 }
 
-void onNfcId(String hexId) {
+void onNfcId(const TagId& id) {
   if (state == PLAY_SELECTED || state == PLAY_PAUSED) {
     return;
   }
 
-  File file = SD.open("nfc.cfg");
-  Properties cfg = Properties(file);
-  String path = cfg.readString(hexId);
-  file.close();
-
-  if (path.length() == 0) {
-    Serial.print(F("Unknown nfc id ")); Serial.println(hexId);
-    File file = SD.open("nfc.cfg", FILE_WRITE);
-    file.write(hexId.c_str());
-    file.write("=\n");
-    file.close();
+  char hexId[TAG_HEX_LENGTH];
+  char path[CONFIG_VALUE_LENGTH];
+  bool configured;
+  long offset = tagCache.get(id, path, sizeof(path));
+  if (offset >= 0) {
+    // short paths are cached, no access to the SD card
+    configured = path[0] != '\0' || nfcCfg.readValue(offset, path, sizeof(path));
   } else {
+    configured = nfcCfg.lookup(id.toHex(hexId), path, sizeof(path), &offset);
+    if (configured && offset >= 0) {
+      tagCache.put(id, offset, path);
+    }
+  }
+  tagCache.printStatistics();
+
+  if (!configured) {
+    // path written on the tag, added to nfc.cfg to skip reading the tag next time,
+    // an unknown id is added once (empty) to be configured by hand
+    configured = nfc.readPath(id, path, sizeof(path));
+    if (!configured) path[0] = '\0';
+    id.toHex(hexId);
+    Serial.print(configured ? F("Learned nfc id ") : F("Unknown nfc id ")); Serial.println(hexId);
+    if (configured || offset < 0) {
+      File file = SD.open("nfc.cfg", FILE_WRITE);
+      offset = file.size() + strlen(hexId) + 1;
+      file.write(hexId);
+      file.write('=');
+      file.write(path);
+      file.write('\n');
+      file.close();
+    }
+    tagCache.put(id, offset, path);
+  }
+
+  if (configured) {
     Serial.print(F("Playing ")); Serial.println(path);
     onNfcPlay(path);
   }
 }
 
-void onNfcPlay(String path) {
+void onNfcPlay(const char* path) {
   state = PLAY_SELECTED;
   playingAlbum = 0;
   matrix.blink(playingAlbum, true);
-  nextTimeoutTick = 0; // no timeout during playing
-  nextNfcTick = 0; // no nfc reading during playing
+  scheduler.cancel(TASK_TIMEOUT); // no timeout during playing
+  scheduler.cancel(TASK_READ_NFC); // no nfc reading during playing
   enableNfc(false);
   player.enable(true);
-  player.startPlaying(path.c_str());
+  player.startPlaying(path);
+  scheduler.after(TASK_TRACK_END, TRACK_DELAY);
 }
 
 void onTryNextTrack() {
@@ -403,30 +460,24 @@ void onPause(bool pause) {
     Serial.println(F("Pause"));
     matrix.blink(playingAlbum, false);
     player.pause(true);
-    nextTimeoutTick = millis() + PAUSE_TIMEOUT;
+    scheduler.after(TASK_TIMEOUT, PAUSE_TIMEOUT);
+    scheduler.after(TASK_IDLE_SHOW, PAUSE_DELAY);
     state = PLAY_PAUSED;
   } else {
     Serial.println(F("Resume"));
     matrix.blink(playingAlbum, true);
     player.pause(false);
-    nextTimeoutTick = 0; // no timeout during playing
+    scheduler.cancel(TASK_TIMEOUT); // no timeout during playing
     state = PLAY_SELECTED;
   }
 }
 
 void onStopPlaying() {
+  latency.cancel();
   player.enable(false);
   onEnterIdle(1200);
 }
 
 void enableNfc(bool enable) {
-  pinMode(NFC_RESET_PIN, OUTPUT);
-  if (enable) {
-    Serial.println("Enable NFC");
-    digitalWrite(NFC_RESET_PIN, HIGH);
-    initializeNfc();
-  } else {
-    Serial.println("Disable NFC");
-    digitalWrite(NFC_RESET_PIN, LOW);    
-  }
+  nfc.enable(enable);
 }